@@ -7,6 +7,7 @@
 #include <fstream>
 #include <iostream>
 #include <set>
+#include <sstream>
 #include <string>
 #include "loom/config/ConfigReader.cpp"
 #include "loom/config/LoomConfig.h"
@@ -14,14 +15,63 @@
 #include "loom/optim/CombNoILPOptimizer.h"
 #include "loom/optim/GreedyOptimizer.h"
 #include "loom/optim/ILPEdgeOrderOptimizer.h"
+#include "shared/optim/ILPSolvProv.h"
 #include "shared/rendergraph/Penalties.h"
 #include "shared/rendergraph/RenderGraph.h"
 #include "util/geo/PolyLine.h"
 #include "util/geo/output/GeoGraphJsonOutput.h"
+#include "util/json/Writer.h"
 #include "util/log/Log.h"
 
 using namespace loom;
 
+// _____________________________________________________________________________
+optim::OptResStats optimize(const config::Config* cfg,
+                            const shared::rendergraph::Penalties& pens,
+                            shared::rendergraph::RenderGraph* g) {
+  if (cfg->optimMethod == "ilp-naive") {
+    optim::ILPOptimizer ilpOptim(cfg, pens);
+    return ilpOptim.optimize(g);
+  } else if (cfg->optimMethod == "ilp") {
+    optim::ILPEdgeOrderOptimizer ilpEoOptim(cfg, pens);
+    return ilpEoOptim.optimize(g);
+  } else if (cfg->optimMethod == "comb") {
+    optim::CombOptimizer ilpCombiOptim(cfg, pens);
+    return ilpCombiOptim.optimize(g);
+  } else if (cfg->optimMethod == "comb-no-ilp") {
+    optim::CombNoILPOptimizer noIlpCombiOptim(cfg, pens);
+    return noIlpCombiOptim.optimize(g);
+  } else if (cfg->optimMethod == "exhaust") {
+    optim::ExhaustiveOptimizer exhausOptim(cfg, pens);
+    return exhausOptim.optimize(g);
+  } else if (cfg->optimMethod == "hillc") {
+    optim::HillClimbOptimizer hillcOptim(cfg, pens, false);
+    return hillcOptim.optimize(g);
+  } else if (cfg->optimMethod == "hillc-random") {
+    optim::HillClimbOptimizer hillcOptim(cfg, pens, true);
+    return hillcOptim.optimize(g);
+  } else if (cfg->optimMethod == "anneal") {
+    optim::SimulatedAnnealingOptimizer annealOptim(cfg, pens, false);
+    return annealOptim.optimize(g);
+  } else if (cfg->optimMethod == "anneal-random") {
+    optim::SimulatedAnnealingOptimizer annealOptim(cfg, pens, true);
+    return annealOptim.optimize(g);
+  } else if (cfg->optimMethod == "greedy") {
+    optim::GreedyOptimizer greedyOptim(cfg, pens, false);
+    return greedyOptim.optimize(g);
+  } else if (cfg->optimMethod == "greedy-lookahead") {
+    optim::GreedyOptimizer greedyOptim(cfg, pens, true);
+    return greedyOptim.optimize(g);
+  } else if (cfg->optimMethod == "null") {
+    optim::NullOptimizer nullOptim(cfg, pens);
+    return nullOptim.optimize(g);
+  }
+
+  LOG(ERROR) << "Unknown optimization method " << cfg->optimMethod
+             << std::endl;
+  exit(1);
+}
+
 // _____________________________________________________________________________
 int main(int argc, char** argv) {
   // initialize randomness
@@ -35,10 +85,18 @@ int main(int argc, char** argv) {
   LOGTO(DEBUG, std::cerr) << "Reading graph...";
   shared::rendergraph::RenderGraph g(5, 1, 5);
 
+  // in benchmark mode, the input is read several times
+  std::stringstream input;
+  std::istream* in = &std::cin;
+  if (cfg.ilpProfileBench) {
+    input << std::cin.rdbuf();
+    in = &input;
+  }
+
   if (cfg.fromDot) {
-    g.readFromDot(&std::cin);
+    g.readFromDot(in);
   } else {
-    g.readFromJson(&std::cin);
+    g.readFromJson(in);
   }
 
   LOGTO(DEBUG, std::cerr) << "Optimizing...";
@@ -62,50 +120,51 @@ int main(int argc, char** argv) {
                                       cfg.stationSeparationWeight,
                                       true,
                                       true};
-  loom::optim::OptResStats stats;
-
-  if (cfg.optimMethod == "ilp-naive") {
-    optim::ILPOptimizer ilpOptim(&cfg, pens);
-    stats = ilpOptim.optimize(&g);
-  } else if (cfg.optimMethod == "ilp") {
-    optim::ILPEdgeOrderOptimizer ilpEoOptim(&cfg, pens);
-    stats = ilpEoOptim.optimize(&g);
-  } else if (cfg.optimMethod == "comb") {
-    optim::CombOptimizer ilpCombiOptim(&cfg, pens);
-    stats = ilpCombiOptim.optimize(&g);
-  } else if (cfg.optimMethod == "comb-no-ilp") {
-    optim::CombNoILPOptimizer noIlpCombiOptim(&cfg, pens);
-    stats = noIlpCombiOptim.optimize(&g);
-  } else if (cfg.optimMethod == "exhaust") {
-    optim::ExhaustiveOptimizer exhausOptim(&cfg, pens);
-    stats = exhausOptim.optimize(&g);
-  } else if (cfg.optimMethod == "hillc") {
-    optim::HillClimbOptimizer hillcOptim(&cfg, pens, false);
-    stats = hillcOptim.optimize(&g);
-  } else if (cfg.optimMethod == "hillc-random") {
-    optim::HillClimbOptimizer hillcOptim(&cfg, pens, true);
-    stats = hillcOptim.optimize(&g);
-  } else if (cfg.optimMethod == "anneal") {
-    optim::SimulatedAnnealingOptimizer annealOptim(&cfg, pens, false);
-    stats = annealOptim.optimize(&g);
-  } else if (cfg.optimMethod == "anneal-random") {
-    optim::SimulatedAnnealingOptimizer annealOptim(&cfg, pens, true);
-    stats = annealOptim.optimize(&g);
-  } else if (cfg.optimMethod == "greedy") {
-    optim::GreedyOptimizer greedyOptim(&cfg, pens, false);
-    stats = greedyOptim.optimize(&g);
-  } else if (cfg.optimMethod == "greedy-lookahead") {
-    optim::GreedyOptimizer greedyOptim(&cfg, pens, true);
-    stats = greedyOptim.optimize(&g);
-  } else if (cfg.optimMethod == "null") {
-    optim::NullOptimizer nullOptim(&cfg, pens);
-    stats = nullOptim.optimize(&g);
-  } else {
-    LOG(ERROR) << "Unknown optimization method " << cfg.optimMethod
-               << std::endl;
-    exit(1);
+
+  if (cfg.ilpProfileBench) {
+    // optimize a fresh copy of the input graph with each solver profile
+    util::json::Array results;
+    for (const auto& profile : shared::optim::getProfileNames()) {
+      config::Config profCfg = cfg;
+      profCfg.ilpProfile = profile;
+
+      // the profiles only differ for the ILP, all other methods would
+      // produce the same result for each of them
+      if (profCfg.optimMethod != "ilp-naive") profCfg.optimMethod = "ilp";
+
+      shared::rendergraph::RenderGraph pg(5, 1, 5);
+      std::istringstream pin(input.str());
+      if (cfg.fromDot) {
+        pg.readFromDot(&pin);
+      } else {
+        pg.readFromJson(&pin);
+      }
+
+      auto stats = optimize(&profCfg, pens, &pg);
+
+      LOGTO(INFO, std::cerr) << "(bench) Profile '" << profile
+                             << "': avg solve time " << stats.avgSolveTime
+                             << " ms, best score " << stats.score;
+
+      results.push_back(util::json::Dict{
+          {"profile", profile},
+          {"avg_solve_time", stats.avgSolveTime},
+          {"avg_score", stats.avgScore},
+          {"best_score", stats.score},
+          {"max_num_cols_in_comp", stats.maxNumColsPerComp},
+          {"max_num_rows_in_comp", stats.maxNumRowsPerComp}});
+    }
+
+    util::json::Writer wr(&std::cout);
+    wr.val(results);
+    wr.closeAll();
+    std::cout << std::endl;
+
+    return (0);
   }
 
+  loom::optim::OptResStats stats = optimize(&cfg, pens, &g);
+
   util::geo::output::GeoGraphJsonOutput out;
 
   if (cfg.writeStats) {
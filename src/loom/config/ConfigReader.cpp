@@ -78,6 +78,20 @@ void ConfigReader::help(const char* bin) const {
             << " 0 means solver default\n"
             << std::setw(43) << "  --ilp-time-limit arg (=-1)"
             << "ILP solve time limit (seconds), -1 for infinite\n"
+            << std::setw(43) << "  --ilp-rel-gap arg (=0)"
+            << "Stop ILP solve at this relative gap (e.g. 0.01),\n"
+            << std::setw(43) << " "
+            << " 0 means solver default\n"
+            << std::setw(43) << "  --ilp-profile arg (=loom)"
+            << "ILP solver parameter profile, one of generic,\n"
+            << std::setw(43) << " "
+            << " loom, octi\n"
+            << std::setw(43) << "  --ilp-profile-bench"
+            << "Optimize with each ILP solver profile and\n"
+            << std::setw(43) << " "
+            << " output a comparison as JSON instead of the graph,\n"
+            << std::setw(43) << " "
+            << " uses ilp unless ilp-naive is given as method\n"
             << std::setw(43) << "  --dbg-output-path arg (=.)"
             << "Path used for debug output\n"
             << std::setw(43) << "  --output-optgraph"
@@ -107,6 +121,9 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       {"dbg-output-path", required_argument, 0, 14},
       {"output-optgraph", required_argument, 0, 15},
       {"write-stats", no_argument, 0, 16},
+      {"ilp-profile", required_argument, 0, 17},
+      {"ilp-profile-bench", no_argument, 0, 18},
+      {"ilp-rel-gap", required_argument, 0, 19},
       {0, 0, 0, 0}};
 
   int c;
@@ -169,6 +186,15 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 16:
         cfg->writeStats = true;
         break;
+      case 17:
+        cfg->ilpProfile = optarg;
+        break;
+      case 18:
+        cfg->ilpProfileBench = true;
+        break;
+      case 19:
+        cfg->ilpRelGap = atof(optarg);
+        break;
       case 'D':
         cfg->fromDot = true;
         break;
@@ -31,6 +31,7 @@ struct Config {
 
   int ilpTimeLimit = -1;
   int ilpNumThreads = 0;
+  double ilpRelGap = 0;
 
   double crossPenMultiSameSeg = 4;
   double crossPenMultiDiffSeg = 1;
@@ -42,6 +43,8 @@ struct Config {
   std::string worldFilePath;
 
   std::string ilpSolver;
+  std::string ilpProfile = "loom";
+  bool ilpProfileBench = false;
 };
 
 }  // namespace config
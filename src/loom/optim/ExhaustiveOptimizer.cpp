@@ -53,6 +53,8 @@ double ExhaustiveOptimizer::optimizeComp(OptGraph* og,
   bestScore = curScore;
   best = cur;
 
+  double lowerBnd = _optScorer.getCrossingLowerBound(g);
+
   double solSp = solutionSpaceSize(g);
 
   // don't try if it is pointless, assuming we can make 100.000
@@ -69,10 +71,11 @@ double ExhaustiveOptimizer::optimizeComp(OptGraph* og,
 
   while (true) {
     T_START(iter);
-    if (bestScore == 0) {
-      LOGTO(DEBUG, std::cerr)
-          << prefix(depth) << "Found optimal score 0 prematurely after "
-          << iters << " iterations!";
+    if (bestScore <= lowerBnd) {
+      LOGTO(INFO, std::cerr)
+          << prefix(depth) << "(ExhaustiveOptimizer) Score " << bestScore
+          << " reached lower bound " << lowerBnd << " prematurely after "
+          << iters << " iterations, gap " << bestScore - lowerBnd;
       writeHierarch(&best, hc);
       return 0;
     }
@@ -110,8 +113,10 @@ double ExhaustiveOptimizer::optimizeComp(OptGraph* og,
     itTime += T_STOP(iter);
   }
 
-  LOGTO(DEBUG, std::cerr) << prefix(depth) << "Found optimal score "
-                          << bestScore << " after " << iters << " iterations!";
+  LOGTO(INFO, std::cerr) << prefix(depth) << "(ExhaustiveOptimizer) Score "
+                         << bestScore << " after " << iters
+                         << " iterations, lower bound " << lowerBnd
+                         << ", gap " << bestScore - lowerBnd;
 
   writeHierarch(&best, hc);
 
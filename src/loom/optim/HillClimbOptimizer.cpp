@@ -20,7 +20,6 @@ double HillClimbOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>&
                                      HierarOrderCfg* hc, size_t depth,
                                      OptResStats& stats) const {
   UNUSED(stats);
-  UNUSED(depth);
   T_START(1);
   OptOrderCfg cur;
 
@@ -40,7 +39,15 @@ double HillClimbOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>&
     greedy.getFlatConfig(g, &cur);
   }
 
+  double lowerBnd = _optScorer.getCrossingLowerBound(g);
+  double score = getScore(og, g, cur);
+  size_t iters = 0;
+
   while (true) {
+    // the current ordering is provably optimal, stop
+    if (score <= lowerBnd) break;
+
+    iters++;
     double bestChange = 0;
     OptEdge* bestEdge = 0;
     std::vector<const Line*> bestOrder;
@@ -73,8 +80,16 @@ double HillClimbOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>&
     if (bestEdge == 0) break;
 
     cur[bestEdge] = bestOrder;
+
+    // only the score at the adjacent nodes of bestEdge changed
+    score -= bestChange;
   }
 
+  LOGTO(INFO, std::cerr) << prefix(depth) << "(HillClimbOptimizer) Score "
+                         << score << " after " << iters
+                         << " iterations, lower bound " << lowerBnd
+                         << ", gap " << score - lowerBnd;
+
   writeHierarch(&cur, hc);
   return T_STOP(1);
 }
@@ -86,3 +101,11 @@ double HillClimbOptimizer::getScore(OptGraph* og, OptEdge* e,
   if (_optScorer.optimizeSep()) return _optScorer.getTotalScore(e, cur);
   return _optScorer.getCrossingScore(e, cur);
 }
+
+// _____________________________________________________________________________
+double HillClimbOptimizer::getScore(OptGraph* og, const std::set<OptNode*>& g,
+                                    OptOrderCfg& cur) const {
+  UNUSED(og);
+  if (_optScorer.optimizeSep()) return _optScorer.getTotalScore(g, cur);
+  return _optScorer.getCrossingScore(g, cur);
+}
@@ -29,6 +29,8 @@ class HillClimbOptimizer : public ExhaustiveOptimizer {
 
  protected:
   double getScore(OptGraph* og, OptEdge* e, OptOrderCfg& cur) const;
+  double getScore(OptGraph* og, const std::set<OptNode*>& g,
+                  OptOrderCfg& cur) const;
 
   bool _randomStart;
 };
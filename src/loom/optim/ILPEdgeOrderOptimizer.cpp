@@ -79,7 +79,8 @@ void ILPEdgeOrderOptimizer::getConfigurationFromSolution(
 ILPSolver* ILPEdgeOrderOptimizer::createProblem(
     OptGraph* og, const std::set<OptNode*>& g) const {
   UNUSED(og);
-  ILPSolver* lp = shared::optim::getSolver(_cfg->ilpSolver, shared::optim::MIN);
+  ILPSolver* lp = shared::optim::getSolver(_cfg->ilpSolver, shared::optim::MIN,
+                                           _cfg->ilpProfile);
 
   std::set<OptEdge*> processed;
 
@@ -48,6 +48,8 @@ double ILPOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
 
   if (_cfg->ilpTimeLimit >= 0) lp->setTimeLim(_cfg->ilpTimeLimit);
   if (_cfg->ilpNumThreads != 0) lp->setNumThreads(_cfg->ilpNumThreads);
+  if (_cfg->ilpRelGap > 0) lp->setRelGapLim(_cfg->ilpRelGap);
+  lp->setProgressCb(shared::optim::logProgress);
 
   LOGTO(DEBUG, std::cerr) << "Solving ILP problem...";
 
@@ -136,7 +138,8 @@ void ILPOptimizer::getConfigurationFromSolution(
 // _____________________________________________________________________________
 ILPSolver* ILPOptimizer::createProblem(OptGraph* og,
                                        const std::set<OptNode*>& g) const {
-  ILPSolver* lp = shared::optim::getSolver(_cfg->ilpSolver, shared::optim::MIN);
+  ILPSolver* lp = shared::optim::getSolver(_cfg->ilpSolver, shared::optim::MIN,
+                                           _cfg->ilpProfile);
 
   // for every segment s, we define |L(s)|^2 decision variables x_slp
   for (OptNode* n : g) {
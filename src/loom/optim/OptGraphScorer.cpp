@@ -2,6 +2,7 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <algorithm>
 #include <map>
 #include "loom/optim/OptGraph.h"
 #include "loom/optim/OptGraphScorer.h"
@@ -9,7 +10,10 @@
 #include "shared/linegraph/Line.h"
 #include "shared/rendergraph/Penalties.h"
 
+using loom::optim::EdgePair;
+using loom::optim::LinePair;
 using loom::optim::OptGraphScorer;
+using loom::optim::Optimizer;
 using shared::linegraph::Line;
 using shared::linegraph::LineEdge;
 using shared::linegraph::LineNode;
@@ -221,7 +225,7 @@ size_t OptGraphScorer::getNumCrossDiffSeg(OptNode* n, OptEdge* ea,
     }
   }
 
-  return util::inversions(relOrderCross);
+  return inversions(&relOrderCross);
 }
 
 // _____________________________________________________________________________
@@ -290,7 +294,7 @@ std::pair<std::pair<size_t, size_t>, size_t> OptGraphScorer::getNumCrossSeps(
     }
   }
 
-  ret.first.first = util::inversions(relOrderCross);
+  ret.first.first = inversions(&relOrderCross);
   ret.second = seps;
 
   return ret;
@@ -365,8 +369,115 @@ double OptGraphScorer::getSeparationPen(const OptNode* n) const {
   return ret * _pens.splitPen;
 }
 
+// _____________________________________________________________________________
+size_t OptGraphScorer::inversions(std::vector<size_t>* v) {
+  // bottom-up merge sort, counting for each element taken from the right run
+  // the number of elements still left in the left run
+  if (v->size() < 2) return 0;
+
+  size_t ret = 0;
+  std::vector<size_t> buf(v->size());
+  std::vector<size_t>* src = v;
+  std::vector<size_t>* dst = &buf;
+
+  for (size_t w = 1; w < v->size(); w *= 2) {
+    for (size_t lo = 0; lo < v->size(); lo += 2 * w) {
+      size_t mid = std::min(lo + w, v->size());
+      size_t hi = std::min(lo + 2 * w, v->size());
+      size_t i = lo, j = mid, k = lo;
+
+      while (i < mid && j < hi) {
+        if ((*src)[j] < (*src)[i]) {
+          ret += mid - i;
+          (*dst)[k++] = (*src)[j++];
+        } else {
+          (*dst)[k++] = (*src)[i++];
+        }
+      }
+
+      while (i < mid) (*dst)[k++] = (*src)[i++];
+      while (j < hi) (*dst)[k++] = (*src)[j++];
+    }
+    std::swap(src, dst);
+  }
+
+  if (src != v) v->swap(buf);
+
+  return ret;
+}
+
 // _____________________________________________________________________________
 bool OptGraphScorer::optimizeSep() const {
   return _pens.inStatSplitPenDegTwo > 0 || _pens.inStatSplitPen > 0 ||
          _pens.splitPen > 0;
 }
+
+// _____________________________________________________________________________
+double OptGraphScorer::getCrossingLowerBound(
+    const std::set<OptNode*>& g) const {
+  // if two lines on an edge split into different edges at both ends of the
+  // edge, and the ordering avoiding a crossing at the one end induces a
+  // crossing at the other end, the lines must cross at least once - at the
+  // cheaper of the two nodes. Separations are not bounded.
+  double ret = 0;
+
+  for (auto n : g) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      if (!e->getFrom()->pl().node || !e->getTo()->pl().node) continue;
+
+      for (const auto& lp : Optimizer::getLinePairs(e, true)) {
+        auto partnersFr = getSplitPartners(e->getFrom(), e, lp);
+        if (!partnersFr.first) continue;
+
+        auto partnersTo = getSplitPartners(e->getTo(), e, lp);
+        if (!partnersTo.first) continue;
+
+        bool crossFr = Optimizer::crosses(e->getFrom(), e, partnersFr, {0, 1});
+        bool crossTo = Optimizer::crosses(e->getTo(), e, partnersTo, {0, 1});
+
+        if (crossFr != crossTo) {
+          ret += std::min(getCrossingPenDiffSeg(e->getFrom()),
+                          getCrossingPenDiffSeg(e->getTo()));
+        }
+      }
+    }
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+EdgePair OptGraphScorer::getSplitPartners(OptNode* n, OptEdge* e,
+                                          const LinePair& lp) const {
+  // returns the two edges the lines of lp continue into from e at n, or
+  // {0, 0} if they do not continue uniquely into two different edges
+  if (n->getDeg() < 3) return {0, 0};
+
+  OptEdge* eA = 0;
+  OptEdge* eB = 0;
+
+  for (auto f : n->getAdjList()) {
+    if (f == e) continue;
+
+    bool a = OptGraph::hasCtdLineIn(lp.first.line, lp.first.dir, e, f);
+    bool b = OptGraph::hasCtdLineIn(lp.second.line, lp.second.dir, e, f);
+
+    // lines continue together, no ordering is enforced here
+    if (a && b) return {0, 0};
+
+    if (a) {
+      if (eA) return {0, 0};
+      eA = f;
+    }
+
+    if (b) {
+      if (eB) return {0, 0};
+      eB = f;
+    }
+  }
+
+  if (!eA || !eB) return {0, 0};
+
+  return {eA, eB};
+}
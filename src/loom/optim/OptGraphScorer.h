@@ -60,6 +60,9 @@ class OptGraphScorer {
   size_t getNumSeparations(const std::set<OptNode*>& g,
                            const OptOrderCfg& c) const;
 
+  // lower bound on the crossing score of any ordering of component g
+  double getCrossingLowerBound(const std::set<OptNode*>& g) const;
+
   bool optimizeSep() const;
 
   double getSeparationPen(const OptNode* n) const;
@@ -68,8 +71,15 @@ class OptGraphScorer {
 
   const shared::rendergraph::Penalties& getPens() const { return _pens; }
 
+  // number of inversions in v in O(n log n), v is sorted afterwards
+  static size_t inversions(std::vector<size_t>* v);
+
  private:
   shared::rendergraph::Penalties _pens;
+
+  std::pair<OptEdge*, OptEdge*> getSplitPartners(
+      OptNode* n, OptEdge* e,
+      const std::pair<const OptLO, const OptLO>& lp) const;
 };
 }  // namespace optim
 }  // namespace loom
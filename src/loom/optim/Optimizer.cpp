@@ -150,6 +150,12 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
   // for trivial cases
   const NullOptimizer nullOpt(_cfg, _scorer.getPens());
 
+  // unsimplified graph used to score the results of all runs, built only once
+  // and never modified afterwards
+  OptGraph gg(&_scorer);
+  gg.build(rg);
+  auto lnEdgMap = getLnEdgMap(&gg);
+
   double bestScore = std::numeric_limits<double>::infinity();
   OrderCfg bestCfg;
 
@@ -241,24 +247,36 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
 
     tSum += t;
 
-    OptGraph gg(&_scorer);
-    auto ndMap = gg.build(rg);
+    auto optCfg = getOptOrderCfg(c, lnEdgMap);
+
+    // count crossings and separations in a single pass over the nodes
+    double score = 0;
+    std::pair<size_t, size_t> crossings = {0, 0};
+    size_t separations = 0;
+
+    for (auto n : gg.getNds()) {
+      auto num = _scorer.getNumCrossSeps(n, optCfg);
+
+      crossings.first += num.first.first;
+      crossings.second += num.first.second;
+      separations += num.second;
 
-    auto optCfg = getOptOrderCfg(c, ndMap, &gg);
+      if (!n->pl().node) continue;
 
-    double score = _scorer.getCrossingScore(&gg, optCfg);
+      score += num.first.first * _scorer.getCrossingPenSameSeg(n) +
+               num.first.second * _scorer.getCrossingPenDiffSeg(n);
 
-    if (_scorer.optimizeSep()) score += _scorer.getSeparationScore(&gg, optCfg);
+      if (_scorer.optimizeSep()) {
+        score += num.second * _scorer.getSeparationPen(n);
+      }
+    }
 
     scoreSum += score;
 
-    auto crossings = _scorer.getNumCrossings(&gg, optCfg);
     crossSumSame += crossings.first;
     crossSumDiff += crossings.second;
     crossSum += crossings.first + crossings.second;
 
-    size_t separations = _scorer.getNumSeparations(&gg, optCfg);
-
     sepSum += separations;
 
     if (score < bestScore) {
@@ -487,21 +505,35 @@ double Optimizer::optimizeComp(OptGraph* g, const std::set<OptNode*>& cmp,
 }
 
 // _____________________________________________________________________________
-OptOrderCfg Optimizer::getOptOrderCfg(
-    const shared::rendergraph::OrderCfg& cfg,
-    const std::map<const LineNode*, OptNode*>& ndMap, const OptGraph* g) {
+OptOrderCfg Optimizer::getOptOrderCfg(const shared::rendergraph::OrderCfg& cfg,
+                                      const LnEdgMap& lnEdgMap) {
   OptOrderCfg ret;
-  for (auto i : cfg) {
+  for (const auto& i : cfg) {
     auto e = i.first;
-    auto order = i.second;
+    const auto& order = i.second;
 
-    auto opNdFr = ndMap.find(e->getFrom())->second;
-    auto opNdTo = ndMap.find(e->getTo())->second;
-    auto opEdg = g->getEdg(opNdFr, opNdTo);
+    auto& lines = ret[lnEdgMap.find(e)->second];
+    lines.reserve(order.size());
 
     for (auto pos = order.rbegin(); pos != order.rend(); pos++) {
       auto lo = e->pl().lineOccAtPos(*pos);
-      ret[opEdg].push_back(lo.line);
+      lines.push_back(lo.line);
+    }
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+Optimizer::LnEdgMap Optimizer::getLnEdgMap(const OptGraph* g) {
+  // in an unsimplified optim graph, each edge corresponds to exactly one
+  // line graph edge
+  LnEdgMap ret;
+  for (auto n : g->getNds()) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      assert(e->pl().lnEdgParts.size() == 1);
+      ret[e->pl().lnEdgParts.front().lnEdg] = e;
     }
   }
 
@@ -79,10 +79,11 @@ class Optimizer {
   static std::string prefix(size_t depth);
 
  private:
-  static OptOrderCfg getOptOrderCfg(
-      const shared::rendergraph::OrderCfg&,
-      const std::map<const shared::linegraph::LineNode*, OptNode*>& ndMap,
-      const OptGraph* g);
+  typedef std::map<const shared::linegraph::LineEdge*, OptEdge*> LnEdgMap;
+
+  static OptOrderCfg getOptOrderCfg(const shared::rendergraph::OrderCfg&,
+                                    const LnEdgMap& lnEdgMap);
+  static LnEdgMap getLnEdgMap(const OptGraph* g);
 };
 }  // namespace optim
 }  // namespace loom
@@ -22,7 +22,6 @@ double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
                                               HierarOrderCfg* hc, size_t depth,
                                               OptResStats& stats) const {
   T_START(1);
-  UNUSED(depth);
   UNUSED(stats);
   OptOrderCfg cur;
 
@@ -48,16 +47,22 @@ double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
 
   size_t ABORT_AFTER_UNCH = 5;
 
-  while (true) {
+  double lowerBnd = _optScorer.getCrossingLowerBound(g);
+  double score = getScore(og, g, cur);
+
+  // the current ordering is provably optimal
+  bool optimal = score <= lowerBnd;
+
+  while (!optimal) {
     iters++;
 
     double temp = 1000.0 / iters;
 
-    for (size_t i = 0; i < edges.size(); i++) {
+    for (size_t i = 0; i < edges.size() && !optimal; i++) {
       double oldScore = getScore(og, edges[i], cur);
 
-      for (size_t p1 = 0; p1 < cur[edges[i]].size(); p1++) {
-        for (size_t p2 = p1; p2 < cur[edges[i]].size(); p2++) {
+      for (size_t p1 = 0; p1 < cur[edges[i]].size() && !optimal; p1++) {
+        for (size_t p2 = p1; p2 < cur[edges[i]].size() && !optimal; p2++) {
           // switch p1 and p2
           auto tmp = cur[edges[i]][p1];
           cur[edges[i]][p1] = cur[edges[i]][p2];
@@ -70,10 +75,13 @@ double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
 
           if (s < oldScore) {
             // found a better solution, keep it, update score
+            score += s - oldScore;
             oldScore = s;
             k = iters;
+            optimal = score <= lowerBnd;
           } else if (s != oldScore && e > r) {
             // keep solution, despite not bringing any local gain, update score
+            score += s - oldScore;
             oldScore = s;
             k = iters;
           } else {
@@ -89,6 +97,11 @@ double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
     if (iters - k > ABORT_AFTER_UNCH) break;
   }
 
+  LOGTO(INFO, std::cerr) << prefix(depth)
+                         << "(SimulatedAnnealingOptimizer) Score " << score
+                         << " after " << iters << " iterations, lower bound "
+                         << lowerBnd << ", gap " << score - lowerBnd;
+
   writeHierarch(&cur, hc);
   return T_STOP(1);
 }
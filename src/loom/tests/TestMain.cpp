@@ -2,6 +2,9 @@
 // Author: Patrick Brosi
 //
 
+#include <algorithm>
+#include <set>
+#include <string>
 #include <vector>
 
 #include "loom/config/LoomConfig.h"
@@ -418,11 +421,108 @@ static const std::vector<FileTest> fileTests(
 
     });
 
+// exhaustive optimizer which checks for each component that the crossing
+// lower bound does not exceed the crossing optimum. The optimum is found by
+// enumerating all orderings, without stopping early at the lower bound.
+class LowerBndOptimizer : public loom::optim::ExhaustiveOptimizer {
+ public:
+  LowerBndOptimizer(const loom::config::Config* cfg,
+                    const shared::rendergraph::Penalties& pens)
+      : ExhaustiveOptimizer(cfg, pens) {}
+
+  virtual double optimizeComp(loom::optim::OptGraph* og,
+                              const std::set<loom::optim::OptNode*>& g,
+                              shared::rendergraph::HierarOrderCfg* hc,
+                              size_t depth,
+                              loom::optim::OptResStats& stats) const {
+    if (solutionSpaceSize(g) <= 50000) {
+      std::vector<loom::optim::OptEdge*> edges;
+      for (auto n : g)
+        for (auto e : n->getAdjList())
+          if (n == e->getFrom()) edges.push_back(e);
+
+      loom::optim::OptOrderCfg cur;
+      initialConfig(g, &cur, true);
+
+      double best = _optScorer.getCrossingScore(g, cur);
+      bool running = !edges.empty();
+
+      while (running) {
+        for (size_t i = 0; i < edges.size(); i++) {
+          if (std::next_permutation(cur[edges[i]].begin(),
+                                    cur[edges[i]].end())) {
+            break;
+          } else if (i == edges.size() - 1) {
+            running = false;
+          }
+        }
+
+        if (running) best = std::min(best, _optScorer.getCrossingScore(g, cur));
+      }
+
+      TEST(_optScorer.getCrossingLowerBound(g), <=, best);
+    }
+
+    return ExhaustiveOptimizer::optimizeComp(og, g, hc, depth, stats);
+  }
+};
+
 // _____________________________________________________________________________
 int main(int argc, char** argv) {
   UNUSED(argc);
   UNUSED(argv);
 
+  {
+    // inversion counting kernel against the naive pairwise count
+    std::vector<std::vector<size_t>> perms{
+        {}, {3}, {0, 1, 2, 3}, {3, 2, 1, 0}, {2, 0, 2, 1, 0},
+        {5, 1, 4, 1, 0, 7, 3, 3, 2, 9, 6, 0, 8}};
+
+    for (auto perm : perms) {
+      size_t naive = 0;
+      for (size_t i = 0; i < perm.size(); i++) {
+        for (size_t j = i + 1; j < perm.size(); j++) {
+          if (perm[i] > perm[j]) naive++;
+        }
+      }
+
+      TEST(loom::optim::OptGraphScorer::inversions(&perm), ==, naive);
+      TEST(std::is_sorted(perm.begin(), perm.end()), ==, true);
+    }
+  }
+
+  {
+    // the crossing lower bound may never exceed the optimum, as hill climbing
+    // and simulated annealing stop as soon as they reach it
+    loom::config::Config cfg;
+    cfg.untangleGraph = false;
+    cfg.pruneGraph = false;
+    cfg.optimRuns = 1;
+
+    shared::rendergraph::Penalties pensSame{1, 0, 1, 1, 0,
+                                            1, 1, 0, false, false};
+    shared::rendergraph::Penalties pensDiff = pensSame;
+    pensDiff.diffSegCrossPen = 100;
+
+    std::vector<std::string> fnames;
+    for (const auto& test : fileTests) fnames.push_back(test.fname);
+    fnames.push_back("../src/loom/tests/datasets/freiburg-tram.json");
+
+    for (const auto& pensLoc : {pensSame, pensDiff}) {
+      LowerBndOptimizer lowerBndOptim(&cfg, pensLoc);
+
+      for (const auto& fname : fnames) {
+        shared::rendergraph::RenderGraph g(5, 1, 5);
+
+        std::ifstream input;
+        input.open(fname);
+        g.readFromJson(&input, true);
+
+        lowerBndOptim.optimize(&g);
+      }
+    }
+  }
+
   loom::config::Config baseCfg;
   baseCfg.untangleGraph = false;
   baseCfg.pruneGraph = false;
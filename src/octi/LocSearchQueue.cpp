@@ -0,0 +1,87 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include "octi/LocSearchQueue.h"
+
+using octi::LocSearchQueue;
+using octi::LocSearchTask;
+
+// _____________________________________________________________________________
+LocSearchQueue::LocSearchQueue(const std::vector<LocSearchTask>& tasks,
+                               size_t workers)
+    : _tasks(tasks), _ranges(std::max<size_t>(1, workers)) {
+  size_t total = 0;
+  for (const auto& t : _tasks) total += t.nd->getDeg();
+
+  size_t w = 0;
+  size_t acc = 0;
+
+  for (size_t i = 0; i < _tasks.size(); i++) {
+    acc += _tasks[i].nd->getDeg();
+    _ranges[w].end = i + 1;
+
+    // close the range once it holds its share of the total weight
+    if (w + 1 < _ranges.size() && acc * _ranges.size() >= total * (w + 1)) {
+      w++;
+      _ranges[w].begin = i + 1;
+      _ranges[w].end = i + 1;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+bool LocSearchQueue::pop(size_t w, LocSearchTask* task) {
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(_ranges[w].m);
+      if (_ranges[w].begin < _ranges[w].end) {
+        *task = _tasks[_ranges[w].begin++];
+        return true;
+      }
+    }
+
+    if (!steal(w)) return false;
+  }
+}
+
+// _____________________________________________________________________________
+bool LocSearchQueue::steal(size_t w) {
+  while (true) {
+    size_t victim = w;
+    size_t most = 0;
+
+    for (size_t i = 0; i < _ranges.size(); i++) {
+      if (i == w) continue;
+      std::lock_guard<std::mutex> lock(_ranges[i].m);
+      if (_ranges[i].end - _ranges[i].begin > most) {
+        most = _ranges[i].end - _ranges[i].begin;
+        victim = i;
+      }
+    }
+
+    // tasks are never added, so we are done once all ranges are empty
+    if (victim == w) return false;
+
+    size_t begin, end;
+
+    {
+      std::lock_guard<std::mutex> lock(_ranges[victim].m);
+      size_t left = _ranges[victim].end - _ranges[victim].begin;
+
+      // the victim may have drained its range in the meantime
+      if (left == 0) continue;
+
+      // the victim keeps the front half, it is currently working on it
+      end = _ranges[victim].end;
+      begin = end - (left + 1) / 2;
+      _ranges[victim].end = begin;
+    }
+
+    std::lock_guard<std::mutex> lock(_ranges[w].m);
+    _ranges[w].begin = begin;
+    _ranges[w].end = end;
+    return true;
+  }
+}
@@ -0,0 +1,48 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_LOCSEARCHQUEUE_H_
+#define OCTI_LOCSEARCHQUEUE_H_
+
+#include <mutex>
+#include <vector>
+#include "octi/combgraph/CombGraph.h"
+
+namespace octi {
+
+// a single candidate position of a comb node, evaluated during local search
+struct LocSearchTask {
+  combgraph::CombNode* nd;
+  size_t grNdId;
+};
+
+// Work stealing queue for the local search tasks of a single iteration.
+// The task list is split into one contiguous range per worker, balanced by
+// the number of edges a task has to reroute. A worker takes tasks from the
+// front of its own range, so it mostly evaluates the positions of the same
+// node in a row. Once its range is empty, it steals the back half of the
+// fullest range of another worker.
+class LocSearchQueue {
+ public:
+  LocSearchQueue(const std::vector<LocSearchTask>& tasks, size_t workers);
+
+  // the next task for worker w, false if no task is left
+  bool pop(size_t w, LocSearchTask* task);
+
+ private:
+  struct Range {
+    std::mutex m;
+    size_t begin = 0;
+    size_t end = 0;
+  };
+
+  std::vector<LocSearchTask> _tasks;
+  std::vector<Range> _ranges;
+
+  bool steal(size_t w);
+};
+
+}  // namespace octi
+
+#endif  // OCTI_LOCSEARCHQUEUE_H_
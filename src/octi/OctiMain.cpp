@@ -5,6 +5,9 @@
 #include <stdio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <set>
@@ -15,6 +18,7 @@
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/combgraph/CombGraph.h"
 #include "octi/config/ConfigReader.h"
+#include "shared/optim/ILPSolvProv.h"
 #include "shared/linegraph/LineGraph.h"
 #include "util/Misc.h"
 #include "util/geo/Geo.h"
@@ -26,6 +30,8 @@
 #include <omp.h>
 #else
 #define omp_get_num_procs() 1
+#define omp_set_num_threads(n) ((void)(n))
+#define omp_set_max_active_levels(n) ((void)(n))
 #endif
 
 using std::string;
@@ -39,7 +45,10 @@ using util::geo::DPolygon;
 
 struct TotalScore {
   Score score;
-  octi::ilp::ILPStats ilpstats;
+
+  // the sum over no components is optimal, each non-optimal component
+  // clears the flag
+  octi::ilp::ILPStats ilpstats = octi::ilp::ILPStats(0, 0, 0, 0, true);
 
   size_t gridgraphNumNds = 0;
   size_t gridgraphNumEdgs = 0;
@@ -52,6 +61,23 @@ struct TotalScore {
   double timeMs = 0;
 };
 
+// _____________________________________________________________________________
+inline TotalScore operator+(const TotalScore& lh, const TotalScore& rh) {
+  TotalScore ret;
+  ret.score = lh.score + rh.score;
+  ret.ilpstats = lh.ilpstats + rh.ilpstats;
+  ret.gridgraphNumNds = lh.gridgraphNumNds + rh.gridgraphNumNds;
+  ret.gridgraphNumEdgs = lh.gridgraphNumEdgs + rh.gridgraphNumEdgs;
+  ret.combgraphNumNds = lh.combgraphNumNds + rh.combgraphNumNds;
+  ret.combgraphNumEdgs = lh.combgraphNumEdgs + rh.combgraphNumEdgs;
+  ret.inputgraphNumNds = lh.inputgraphNumNds + rh.inputgraphNumNds;
+  ret.inputgraphNumEdgs = lh.inputgraphNumEdgs + rh.inputgraphNumEdgs;
+  ret.inputgraphMaxDeg = std::max(lh.inputgraphMaxDeg, rh.inputgraphMaxDeg);
+  ret.numNoEmbeddingFound = lh.numNoEmbeddingFound + rh.numNoEmbeddingFound;
+  ret.timeMs = lh.timeMs + rh.timeMs;
+  return ret;
+}
+
 // _____________________________________________________________________________
 double avgStatDist(const LineGraph& g) {
   double avg = 0;
@@ -111,10 +137,13 @@ std::vector<DPolygon> readObstacleFile(const std::string& p) {
 void drawComp(LineGraph& tg, double avgDist, util::json::Array& jsonScores,
               std::vector<LineGraph*>& resultGraphs,
               std::vector<BaseGraph*>& resultGridGraphs, TotalScore& totScore,
-              const config::Config& cfg) {
+              const config::Config& cfg, const std::atomic<size_t>* best,
+              size_t attempt) {
   Drawing d;
 
-  Octilinearizer oct(cfg.baseGraphType);
+  // if best is set, the drawing is cancelled once *best drops below attempt
+  Octilinearizer oct(cfg.baseGraphType, cfg.landmarks);
+  oct.setCancel(best, attempt);
   LineGraph* res = new LineGraph();
   BaseGraph* gg;
 
@@ -169,18 +198,36 @@ void drawComp(LineGraph& tg, double avgDist, util::json::Array& jsonScores,
     T_START(octi);
     sc = oct.drawILP(cg, box, res, &gg, &d, cfg.pens, gridSize, cfg.borderRad,
                      cfg.maxGrDist, cfg.orderMethod, cfg.ilpNoSolve,
-                     cfg.enfGeoPen, cfg.hananIters, cfg.ilpTimeLimit,
-                     cfg.ilpCacheDir, cfg.ilpCacheThreshold, cfg.ilpNumThreads,
-                     &ilpstats, cfg.ilpSolver, cfg.ilpPath);
+                     cfg.enfGeoPen, cfg.hananIters, cfg.heurJobs,
+                     cfg.ilpTimeLimit, cfg.ilpCacheDir, cfg.ilpCacheThreshold,
+                     cfg.ilpNumThreads, cfg.ilpRelGap, cfg.ilpCorridor,
+                     cfg.ilpWindow, &ilpstats, cfg.ilpSolver, cfg.ilpProfile,
+                     cfg.ilpPath);
     time = T_STOP(octi);
     LOGTO(DEBUG, std::cerr)
         << "Schematized using ILP in " << time << " ms, score " << sc.full;
   } else if ((cfg.optMode == "heur")) {
     T_START(octi);
-    sc = oct.draw(cg, box, res, &gg, &d, cfg.pens, gridSize, cfg.borderRad,
-                  cfg.maxGrDist, cfg.orderMethod, cfg.restrLocSearch,
-                  cfg.enfGeoPen, cfg.hananIters, cfg.obstacles,
-                  cfg.heurLocSearchIters, cfg.abortAfter);
+    if (cfg.prev) {
+      sc = oct.drawIncremental(
+          cg, box, *cfg.prev, res, &gg, &d, cfg.pens, gridSize, cfg.borderRad,
+          cfg.maxGrDist, cfg.orderMethod, cfg.restrLocSearch, cfg.enfGeoPen,
+          cfg.hananIters, cfg.obstacles, cfg.heurLocSearchIters,
+          cfg.abortAfter, cfg.heurJobs, cfg.locSearchMultiMove);
+    } else if (cfg.multiLevels > 1) {
+      sc = oct.drawMultiLevel(
+          cg, box, res, &gg, &d, cfg.pens, gridSize, cfg.borderRad,
+          cfg.maxGrDist, cfg.orderMethod, cfg.restrLocSearch, cfg.enfGeoPen,
+          cfg.hananIters, cfg.obstacles, cfg.heurLocSearchIters,
+          cfg.abortAfter, cfg.heurJobs, cfg.locSearchMultiMove,
+          cfg.multiLevels);
+    } else {
+      sc = oct.draw(cg, box, res, &gg, &d, cfg.pens, gridSize, cfg.borderRad,
+                    cfg.maxGrDist, cfg.orderMethod, cfg.restrLocSearch,
+                    cfg.enfGeoPen, cfg.hananIters, cfg.obstacles,
+                    cfg.heurLocSearchIters, cfg.abortAfter, cfg.heurJobs,
+                    cfg.locSearchMultiMove, 0, 0);
+    }
     time = T_STOP(octi);
 
     LOGTO(DEBUG, std::cerr) << "Schematized using heur approach in " << time
@@ -253,6 +300,13 @@ void drawComp(LineGraph& tg, double avgDist, util::json::Array& jsonScores,
                                   {"deg2heur", cfg.deg2Heur},
                                   {"max-grid-dist", cfg.maxGrDist}}},
         {"time-ms", time},
+        {"phases",
+         util::json::Dict{{"grid-build-ms", sc.phases.gridMs},
+                          {"geo-pens-ms", sc.phases.geoPensMs},
+                          {"initial-drawing-ms", sc.phases.initMs},
+                          {"local-search-ms", sc.phases.locSearchMs},
+                          {"ilp-ms", sc.phases.ilpMs}}},
+        {"nodes-expanded", sc.phases.ndsExpanded},
         {"iterations", sc.iters},
         {"procs", omp_get_num_procs()},
         {"peak-memory", util::readableSize(maxRss)},
@@ -280,57 +334,158 @@ void drawComp(LineGraph& tg, double avgDist, util::json::Array& jsonScores,
 }
 
 // _____________________________________________________________________________
-int main(int argc, char** argv) {
-  // disable output buffering for standard output
-  setbuf(stdout, NULL);
+void drawCompSpec(const LineGraph& orig, const std::set<LineNode*>& nds,
+                  double avgDist, size_t tries, size_t maxTries,
+                  std::vector<LineGraph*>& copies,
+                  util::json::Array& jsonScores,
+                  std::vector<LineGraph*>& resultGraphs,
+                  std::vector<BaseGraph*>& resultGridGraphs,
+                  TotalScore& totScore, const config::Config& cfg) {
+  // speculative retries: in each round, try the next grid sizes in parallel,
+  // each on a fresh copy of the original component nds of orig, and keep the
+  // largest grid size which could be drawn
+  while (tries < maxTries) {
+    size_t n = std::min(cfg.retryPar, maxTries - tries);
+
+    std::vector<LineGraph*> attCopies(n, 0);
+    std::vector<util::json::Array> attJsonScores(n);
+    std::vector<std::vector<LineGraph*>> attResultGraphs(n);
+    std::vector<std::vector<BaseGraph*>> attResultGridGraphs(n);
+    std::vector<TotalScore> attScores(n);
+
+    // split the heuristic workers between the attempts
+    config::Config attCfg = cfg;
+    size_t heurJobs = cfg.heurJobs ? cfg.heurJobs : omp_get_num_procs();
+    attCfg.heurJobs = std::max<size_t>(1, heurJobs / n);
+
+    // index of the best successful attempt so far, running attempts on
+    // smaller grids are cancelled as soon as it drops below their index
+    std::atomic<size_t> best(n);
+
+#pragma omp parallel for num_threads(n) schedule(dynamic, 1)
+    for (size_t a = 0; a < n; a++) {
+      omp_set_num_threads(attCfg.heurJobs);
+
+      // an attempt on a larger grid already succeeded
+      if (best < a) continue;
+
+      double curDist = avgDist * pow(0.85, tries + a);
+      LOGTO(DEBUG, std::cerr) << "Trying grid size " << curDist;
+
+      // the copy is only made once the attempt actually runs
+      attCopies[a] = new LineGraph();
+      orig.extractComp(nds, attCopies[a]);
 
-  // initialize randomness
-  srand(time(NULL) + rand());
-
-  config::Config cfg;
+      try {
+        drawComp(*attCopies[a], curDist, attJsonScores[a], attResultGraphs[a],
+                 attResultGridGraphs[a], attScores[a], attCfg, &best, a);
+        size_t cur = best;
+        while (a < cur && !best.compare_exchange_weak(cur, a)) {
+        }
+      } catch (const DrawingCancelledExc&) {
+        LOGTO(DEBUG, std::cerr) << "Grid size " << curDist << " cancelled";
+      } catch (const NoEmbeddingFoundExc&) {
+        LOGTO(DEBUG, std::cerr) << "Grid size " << curDist << " failed";
+      }
+    }
 
-  config::ConfigReader cr;
-  cr.read(&cfg, argc, argv);
+    // free the results and copies of all attempts except the best one
+    for (size_t a = 0; a < n; a++) {
+      if (a == best) continue;
+      for (auto res : attResultGraphs[a]) delete res;
+      for (auto gg : attResultGridGraphs[a]) delete gg;
+      delete attCopies[a];
+    }
 
-  util::geo::output::GeoGraphJsonOutput out;
+    if (best < n) {
+      LOGTO(DEBUG, std::cerr) << "Drawn with grid size "
+                              << avgDist * pow(0.85, tries + best);
+      copies.push_back(attCopies[best]);
+      jsonScores.insert(jsonScores.end(), attJsonScores[best].begin(),
+                        attJsonScores[best].end());
+      resultGraphs.insert(resultGraphs.end(), attResultGraphs[best].begin(),
+                          attResultGraphs[best].end());
+      resultGridGraphs.insert(resultGridGraphs.end(),
+                              attResultGridGraphs[best].begin(),
+                              attResultGridGraphs[best].end());
+      totScore = totScore + attScores[best];
+      return;
+    }
 
-  if (cfg.obstaclePath.size()) {
-    LOGTO(DEBUG, std::cerr) << "Reading obstacle file...";
-    cfg.obstacles = readObstacleFile(cfg.obstaclePath);
-    LOGTO(DEBUG, std::cerr) << "Done. (" << cfg.obstacles.size() << " obst.)";
+    tries += n;
+    LOGTO(WARN, std::cerr) << "Retrying with grid size "
+                           << avgDist * pow(0.85, tries);
   }
 
-  LOGTO(DEBUG, std::cerr) << "Reading graph file...";
-  T_START(read);
-  LineGraph lg;
-
-  if (cfg.fromDot)
-    lg.readFromDot(&(std::cin));
-  else
-    lg.readFromJson(&(std::cin));
-
-  LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(read) << "ms)";
+  throw NoEmbeddingFoundExc();
+}
 
-  LOGTO(DEBUG, std::cerr) << "Planarizing graph...";
-  T_START(planarize);
-  lg.topologizeIsects();
-  LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(planarize) << "ms)";
+// _____________________________________________________________________________
+void drawComps(const LineGraph& lg,
+               const std::vector<std::set<LineNode*>>& compNds,
+               std::vector<LineGraph>& comps,
+               std::vector<std::vector<LineGraph*>>& compCopies,
+               util::json::Array& jsonScores,
+               std::vector<LineGraph*>& resultGraphs,
+               std::vector<BaseGraph*>& resultGridGraphs, TotalScore& totScore,
+               const config::Config& cfg) {
+  // the input graph lg is kept unchanged, each component is drawn on its own
+  // copy in comps. Speculative retries copy their components from lg again,
+  // the copies of successful retries are kept in compCopies.
+  comps.resize(compNds.size());
+  for (size_t i = 0; i < comps.size(); i++) {
+    lg.extractComp(compNds[i], &comps[i]);
+  }
 
-  std::vector<LineGraph> comps = lg.distConnectedComponents(10000, false);
+  compCopies.resize(comps.size());
 
-  util::json::Array jsonScores;
-  std::vector<LineGraph*> resultGraphs;
-  std::vector<BaseGraph*> resultGridGraphs;
+  bool specRetry = cfg.retryOnError && cfg.retryPar > 1;
 
   LOGTO(DEBUG, std::cerr) << "Broke input graph into " << comps.size()
                           << " components";
 
-  TotalScore totScore;
+  // components are drawn independently, each into its own result slot
+  std::vector<util::json::Array> compJsonScores(comps.size());
+  std::vector<std::vector<LineGraph*>> compResultGraphs(comps.size());
+  std::vector<std::vector<BaseGraph*>> compResultGridGraphs(comps.size());
+  std::vector<TotalScore> compScores(comps.size());
+
+  // errors can't be raised inside the parallel loop, they are reported in
+  // input order afterwards
+  std::vector<std::string> compErrors(comps.size());
+
+  size_t compJobs = cfg.compJobs;
+  if (compJobs == 0) compJobs = omp_get_num_procs();
+
+  // the ILP solvers bring their own parallelism
+  if (cfg.optMode == "ilp") compJobs = 1;
+  compJobs = std::max<size_t>(1, std::min(compJobs, comps.size()));
+
+  // split the thread budget between components and the heuristic workers
+  // inside each component
+  config::Config compCfg = cfg;
+  size_t innerJobs = std::max<size_t>(1, omp_get_num_procs() / compJobs);
+  if (compJobs > 1) {
+    if (compCfg.heurJobs == 0 || compCfg.heurJobs > innerJobs) {
+      compCfg.heurJobs = innerJobs;
+    }
+    LOGTO(DEBUG, std::cerr) << "Drawing " << compJobs
+                            << " components in parallel, " << compCfg.heurJobs
+                            << " worker(s) each";
+  }
 
-  size_t i = 0;
+  // nested parallel levels: components, speculative retries, heur workers
+  int levels = 1;
+  if (compJobs > 1) levels++;
+  if (specRetry) levels++;
+  if (levels > 1) omp_set_max_active_levels(levels);
+
+#pragma omp parallel for num_threads(compJobs) schedule(dynamic)
+  for (size_t i = 0; i < comps.size(); i++) {
+    if (compJobs > 1) omp_set_num_threads(innerJobs);
 
-  for (auto& tg : comps) {
-    LOGTO(DEBUG, std::cerr) << "@ component " << i++;
+    auto& tg = comps[i];
+    LOGTO(DEBUG, std::cerr) << "@ component " << i;
     double avgDist = avgStatDist(tg);
 
     double curDist = avgDist;
@@ -342,12 +497,26 @@ int main(int argc, char** argv) {
 
     while (tries < MAX_TRIES) {
       try {
-        drawComp(tg, curDist, jsonScores, resultGraphs, resultGridGraphs,
-                 totScore, cfg);
+        if (specRetry && tries > 0) {
+          drawCompSpec(lg, compNds[i], avgDist, tries, MAX_TRIES,
+                       compCopies[i], compJsonScores[i], compResultGraphs[i],
+                       compResultGridGraphs[i], compScores[i], compCfg);
+        } else {
+          drawComp(tg, curDist, compJsonScores[i], compResultGraphs[i],
+                   compResultGridGraphs[i], compScores[i], compCfg, 0, 0);
+        }
 
         break;
       } catch (const NoEmbeddingFoundExc& exc) {
-        if (cfg.retryOnError && tries < MAX_TRIES) {
+        if (specRetry && tries == 0) {
+          // the first grid size failed, try the next ones in parallel
+          tries++;
+          LOGTO(WARN, std::cerr) << "Retrying with " << cfg.retryPar
+                                 << " grid sizes in parallel";
+          continue;
+        }
+
+        if (cfg.retryOnError && !specRetry && tries < MAX_TRIES) {
           curDist *= 0.85;
           tries++;
           LOGTO(WARN, std::cerr) << "Retrying with grid size " << curDist;
@@ -355,18 +524,145 @@ int main(int argc, char** argv) {
         }
 
         if (cfg.skipOnError) {
-          totScore.numNoEmbeddingFound += 1;
-          jsonScores.push_back(util::json::Dict());
+          compScores[i].numNoEmbeddingFound += 1;
+          compJsonScores[i].push_back(util::json::Dict());
           LOGTO(WARN, std::cerr) << exc.what();
           break;
         }
 
-        LOG(ERROR) << exc.what();
-        exit(1);
+        compErrors[i] = exc.what();
+        break;
       }
     }
   }
 
+  for (const auto& err : compErrors) {
+    if (err.empty()) continue;
+    LOG(ERROR) << err;
+    exit(1);
+  }
+
+  // assemble results in input order
+  for (size_t i = 0; i < comps.size(); i++) {
+    jsonScores.insert(jsonScores.end(), compJsonScores[i].begin(),
+                      compJsonScores[i].end());
+    resultGraphs.insert(resultGraphs.end(), compResultGraphs[i].begin(),
+                        compResultGraphs[i].end());
+    resultGridGraphs.insert(resultGridGraphs.end(),
+                            compResultGridGraphs[i].begin(),
+                            compResultGridGraphs[i].end());
+    totScore = totScore + compScores[i];
+  }
+}
+
+// _____________________________________________________________________________
+int main(int argc, char** argv) {
+  // disable output buffering for standard output
+  setbuf(stdout, NULL);
+
+  // initialize randomness
+  srand(time(NULL) + rand());
+
+  config::Config cfg;
+
+  config::ConfigReader cr;
+  cr.read(&cfg, argc, argv);
+
+  util::geo::output::GeoGraphJsonOutput out;
+
+  if (cfg.obstaclePath.size()) {
+    LOGTO(DEBUG, std::cerr) << "Reading obstacle file...";
+    cfg.obstacles = readObstacleFile(cfg.obstaclePath);
+    LOGTO(DEBUG, std::cerr) << "Done. (" << cfg.obstacles.size() << " obst.)";
+  }
+
+  LineGraph prev;
+  if (cfg.prevPath.size()) {
+    LOGTO(DEBUG, std::cerr) << "Reading previous drawing...";
+    std::ifstream s;
+    s.open(cfg.prevPath);
+    prev.readFromJson(&s);
+    cfg.prev = &prev;
+    LOGTO(DEBUG, std::cerr) << "Done. (" << prev.getNds().size() << " nodes)";
+  }
+
+  LOGTO(DEBUG, std::cerr) << "Reading graph file...";
+  T_START(read);
+  LineGraph lg;
+
+  if (cfg.fromDot)
+    lg.readFromDot(&(std::cin));
+  else
+    lg.readFromJson(&(std::cin));
+
+  LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(read) << "ms)";
+
+  LOGTO(DEBUG, std::cerr) << "Planarizing graph...";
+  T_START(planarize);
+  lg.topologizeIsects();
+  LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(planarize) << "ms)";
+
+  auto compNds = lg.distConnectedNdSets(10000);
+
+  if (cfg.ilpProfileBench) {
+    // draw the components with the ILP and each solver profile
+    util::json::Array results;
+    for (const auto& profile : shared::optim::getProfileNames()) {
+      config::Config profCfg = cfg;
+      profCfg.ilpProfile = profile;
+      profCfg.optMode = "ilp";
+
+      // the solve times and scores are only collected with the stats
+      profCfg.writeStats = true;
+
+      std::vector<LineGraph> comps;
+      std::vector<std::vector<LineGraph*>> compCopies;
+      util::json::Array jsonScores;
+      std::vector<LineGraph*> resultGraphs;
+      std::vector<BaseGraph*> resultGridGraphs;
+      TotalScore totScore;
+
+      drawComps(lg, compNds, comps, compCopies, jsonScores, resultGraphs,
+                resultGridGraphs, totScore, profCfg);
+
+      LOGTO(INFO, std::cerr) << "(bench) Profile '" << profile
+                             << "': solve time " << totScore.ilpstats.time
+                             << " ms, score " << totScore.score.full;
+
+      results.push_back(util::json::Dict{
+          {"profile", profile},
+          {"time-ms", totScore.timeMs},
+          {"solve-time", totScore.ilpstats.time},
+          {"total-score", totScore.score.full},
+          {"optimal", util::json::Bool{totScore.ilpstats.optimal}},
+          {"rows", totScore.ilpstats.rows},
+          {"cols", totScore.ilpstats.cols}});
+
+      for (auto gg : resultGridGraphs) delete gg;
+      for (auto res : resultGraphs) delete res;
+    }
+
+    util::json::Writer wr(&std::cout);
+    wr.val(results);
+    wr.closeAll();
+    std::cout << std::endl;
+
+    return 0;
+  }
+
+  // the results may reference the component graphs, they have to outlive
+  // the output
+  std::vector<LineGraph> comps;
+  std::vector<std::vector<LineGraph*>> compCopies;
+
+  util::json::Array jsonScores;
+  std::vector<LineGraph*> resultGraphs;
+  std::vector<BaseGraph*> resultGridGraphs;
+  TotalScore totScore;
+
+  drawComps(lg, compNds, comps, compCopies, jsonScores, resultGraphs,
+            resultGridGraphs, totScore, cfg);
+
   util::geo::output::GeoGraphJsonOutput gout;
 
   size_t maxRss = util::getPeakRSS();
@@ -408,6 +704,13 @@ int main(int argc, char** argv) {
       {"num-comps-no-embedding-found", totScore.numNoEmbeddingFound},
       {"num-comps", comps.size()},
       {"time-ms", totScore.timeMs},
+      {"phases",
+       util::json::Dict{{"grid-build-ms", totScore.score.phases.gridMs},
+                        {"geo-pens-ms", totScore.score.phases.geoPensMs},
+                        {"initial-drawing-ms", totScore.score.phases.initMs},
+                        {"local-search-ms", totScore.score.phases.locSearchMs},
+                        {"ilp-ms", totScore.score.phases.ilpMs}}},
+      {"nodes-expanded", totScore.score.phases.ndsExpanded},
       {"iterations", totScore.score.iters},
       {"procs", omp_get_num_procs()},
       {"peak-memory", util::readableSize(maxRss)},
@@ -4,12 +4,18 @@
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include "ilp/ILPGridOptimizer.h"
+#include "octi/LocSearchQueue.h"
 #include "octi/Octilinearizer.h"
+#include "octi/PrevDrawing.h"
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/basegraph/ConvexHullOctiGridGraph.h"
 #include "octi/basegraph/GridGraph.h"
+#include "octi/basegraph/GridOverlay.h"
+#include "octi/basegraph/GridRouter.h"
 #include "octi/basegraph/HexGridGraph.h"
 #include "octi/basegraph/NodeCost.h"
 #include "octi/basegraph/OctiGridGraph.h"
@@ -30,6 +36,9 @@ using namespace util;
 
 using combgraph::EdgeOrdering;
 using octi::basegraph::BaseGraph;
+using octi::basegraph::GridLandmarks;
+using octi::basegraph::GridOverlay;
+using octi::basegraph::GridRouter;
 using octi::combgraph::Drawing;
 using octi::config::OrderMethod;
 using octi::ilp::ILPStats;
@@ -43,39 +52,80 @@ using util::geo::Polygon;
 using util::graph::BiDijkstra;
 using util::graph::Dijkstra;
 
+// _____________________________________________________________________________
+static GridRouter* router() {
+  // routing state is kept per thread, as the heuristic workers route on their
+  // own overlays in parallel
+  static thread_local GridRouter r;
+  return &r;
+}
+
+// _____________________________________________________________________________
+static std::vector<OrderMethod> getOrderMethods(OrderMethod orderMethod) {
+  if (orderMethod != OrderMethod::ALL) return {orderMethod};
+
+  // try our default edge ordering first, without any randomization
+  return {OrderMethod::NUM_LINES,     OrderMethod::LENGTH,
+          OrderMethod::ADJ_ND_DEGREE, OrderMethod::ADJ_ND_LDEGREE,
+          OrderMethod::GROWTH_DEG,    OrderMethod::GROWTH_LDEG};
+}
+
+// _____________________________________________________________________________
+static void writeGeoPens(const BaseGraph* gg,
+                         const std::vector<CombEdge*>& edges, double pen,
+                         GeoPensMap* target) {
+  // the map entries are created up front, the workers then only write into
+  // their own (disjoint) GeoPens
+  std::vector<GeoPens*> pens(edges.size());
+  for (size_t i = 0; i < edges.size(); i++) pens[i] = &(*target)[edges[i]];
+
+#pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < edges.size(); i++) {
+    gg->writeGeoCoursePens(edges[i], pens[i], pen);
+  }
+}
+
+// _____________________________________________________________________________
+static void writeCorridorPens(const BaseGraph* gg,
+                              const std::vector<CombEdge*>& edges,
+                              const EdgeCorridors& corridors, double width,
+                              GeoPensMap* target) {
+  std::vector<GeoPens*> pens(edges.size());
+  for (size_t i = 0; i < edges.size(); i++) pens[i] = &(*target)[edges[i]];
+
+#pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < edges.size(); i++) {
+    auto corr = corridors.find(edges[i]);
+    if (corr == corridors.end()) continue;
+    gg->writeCorridorPens({corr->second}, pens[i], width);
+  }
+}
+
 // _____________________________________________________________________________
 Score Octilinearizer::drawILP(
     const CombGraph& cg, const util::geo::DBox& box, LineGraph* outTg,
     BaseGraph** retGg, Drawing* dOut, const Penalties& pens, double gridSize,
     double borderRad, double maxGrDist, OrderMethod orderMethod, bool noSolve,
-    double enfGeoPen, size_t hananIters, int timeLim,
+    double enfGeoPen, size_t hananIters, size_t jobs, int timeLim,
     const std::string& cacheDir, double cacheThreshold, int numThreads,
-    octi::ilp::ILPStats* stats, const std::string& solverStr,
-    const std::string& path) {
-  BaseGraph* gg;
+    double relGap, double corridor, double window, octi::ilp::ILPStats* stats,
+    const std::string& solverStr,
+    const std::string& solverProfile, const std::string& path) {
   Drawing drawing;
+  bool presolved = false;
+  PhaseStats phases;
 
   // always set density penality to 0, cannot by used in ILP and prevents proper
   // presolve by our approximate approach
   Penalties pensCpy = pens;
   pensCpy.densityPen = 0;
 
-  LOGTO(DEBUG, std::cerr) << "Presolving...";
-  try {
-    // presolve using heuristical approach to get a first feasible solution
-    LineGraph tmpOutTg;
-    // important: always use restrLocSearch here!
-    auto score = draw(cg, box, &tmpOutTg, &gg, &drawing, pensCpy, gridSize,
-                      borderRad, maxGrDist, orderMethod, true, enfGeoPen,
-                      hananIters, {}, 100, std::numeric_limits<size_t>::max());
-    if (score.violations) throw NoEmbeddingFoundExc();
-    LOGTO(DEBUG, std::cerr) << "Presolving finished.";
-  } catch (const NoEmbeddingFoundExc& exc) {
-    LOGTO(DEBUG, std::cerr) << "Presolve was not successful.";
-    gg = newBaseGraph(box, cg, gridSize, borderRad, hananIters, pensCpy);
-    gg->init();
-    drawing = Drawing(gg);
-  }
+  // the presolve runs on the same base graph and geo pens as the ILP
+  size_t locSearchIters = 100;
+  size_t noAbort = std::numeric_limits<size_t>::max();
+  BaseGraph* gg = 0;
+  phases.gridMs =
+      buildBaseGraph(box, cg, gridSize, borderRad, hananIters, pensCpy, &gg);
 
   GeoPensMap enfGeoPens;
   const GeoPensMap* geoPens = 0;
@@ -84,13 +134,36 @@ Score Octilinearizer::drawILP(
     auto edges = getOrdering(cg, OrderMethod::NUM_LINES);
     LOGTO(DEBUG, std::cerr) << "Writing geopens for " << edges.size() << " edges";
     T_START(geopens);
-    for (auto cmbEdg : edges) {
-      gg->writeGeoCoursePens(cmbEdg, &enfGeoPens, enfGeoPen);
-    }
-    LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(geopens) << "ms)";
+    writeGeoPens(gg, edges, enfGeoPen, &enfGeoPens);
+    phases.geoPensMs = T_STOP(geopens);
+    LOGTO(DEBUG, std::cerr) << "Done. (" << phases.geoPensMs << "ms)";
     geoPens = &enfGeoPens;
   }
 
+  LOGTO(DEBUG, std::cerr) << "Presolving...";
+  try {
+    // presolve using heuristical approach to get a first feasible solution
+    // important: always use restrLocSearch here!
+    size_t heurJobs =
+        numWorkers(cg, orderMethod, locSearchIters, noAbort, jobs);
+    auto score = draw(cg, gg, heurJobs, &drawing, maxGrDist, orderMethod, true,
+                      {}, locSearchIters, noAbort, false, geoPens);
+    phases = phases + score.phases;
+    if (score.violations) {
+      // start the ILP from an empty grid
+      drawing.eraseFromGrid(gg);
+      throw NoEmbeddingFoundExc();
+    }
+    presolved = true;
+    LOGTO(DEBUG, std::cerr) << "Presolving finished.";
+  } catch (const DrawingCancelledExc&) {
+    delete gg;
+    throw;
+  } catch (const NoEmbeddingFoundExc& exc) {
+    LOGTO(DEBUG, std::cerr) << "Presolve was not successful.";
+    drawing = Drawing(gg);
+  }
+
   // TODO
   // if (obstacles.size()) {
   // std::cerr << "Writing obstacles... ";
@@ -102,9 +175,26 @@ Score Octilinearizer::drawILP(
 
   ilp::ILPGridOptimizer ilpoptim;
 
-  *stats =
-      ilpoptim.optimize(gg, cg, &drawing, maxGrDist, noSolve, geoPens, timeLim,
-                        cacheDir, cacheThreshold, numThreads, solverStr, path);
+  T_START(ilp);
+
+  if (window > 0 && presolved && !noSolve) {
+    // the windows are laid over the presolved drawing
+    *stats = ilpoptim.optimizeWindowed(
+        gg, cg, &drawing, maxGrDist, geoPens, timeLim, cacheDir,
+        cacheThreshold, numThreads, relGap, window, jobs, solverStr,
+        solverProfile);
+  } else {
+    if (window > 0) {
+      LOGTO(INFO, std::cerr) << "No presolved drawing to lay windows over, "
+                                "solving a single ILP";
+    }
+    *stats =
+        ilpoptim.optimize(gg, cg, &drawing, maxGrDist, noSolve, geoPens,
+                          timeLim, cacheDir, cacheThreshold, numThreads,
+                          relGap, corridor, solverStr, solverProfile, path);
+  }
+
+  phases.ilpMs = T_STOP(ilp);
 
   drawing.getLineGraph(outTg);
   *retGg = gg;
@@ -112,6 +202,7 @@ Score Octilinearizer::drawILP(
 
   Score a;
   a.full = stats->score;
+  a.phases = phases;
 
   return a;
 }
@@ -124,25 +215,19 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
                            OrderMethod orderMethod, bool restrLocSearch,
                            double enfGeoPen, size_t hananIters,
                            const std::vector<Polygon<double>>& obstacles,
-                           size_t locSearchIters, size_t abortAfter) {
-  size_t jobs = 4;
-  std::vector<BaseGraph*> ggs(jobs);
-
-  LOGTO(DEBUG, std::cerr) << "Creating grid graphs... ";
-  T_START(ggraph);
-#pragma omp parallel for
-  for (size_t i = 0; i < jobs; i++) {
-    ggs[i] = newBaseGraph(box, cg, gridSize, borderRad, hananIters, pens);
-    ggs[i]->init();
-  }
+                           size_t locSearchIters, size_t abortAfter,
+                           size_t jobs, bool multiMove,
+                           const EdgeCorridors* corridors,
+                           double corridorWidth) {
+  if (cancelled()) throw DrawingCancelledExc();
 
-  LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(ggraph) << "ms)";
+  jobs = numWorkers(cg, orderMethod, locSearchIters, abortAfter, jobs);
 
-  LOGTO(DEBUG, std::cerr) << "Grid graph has " << ggs[0]->getNds().size()
-                          << " nodes";
+  PhaseStats phases;
 
-  size_t LOCAL_SEARCH_ITERS = locSearchIters;
-  double CONVERGENCE_THRESHOLD = 0.05;
+  BaseGraph* gg = 0;
+  phases.gridMs =
+      buildBaseGraph(box, cg, gridSize, borderRad, hananIters, pens, &gg);
 
   GeoPensMap enfGeoPens;
   const GeoPensMap* geoPens = 0;
@@ -150,72 +235,125 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
   // ordering is irrelevant, this is a just a shortcut to get all edges
   auto edges = getOrdering(cg, OrderMethod::NUM_LINES);
 
-  if (enfGeoPen > 0) {
+  if (corridors) {
+    // the coarser solution already follows the geo course, so the corridor
+    // replaces the geo pens
+    LOGTO(DEBUG, std::cerr) << "Writing corridors for " << edges.size()
+                            << " edges";
+    T_START(corrs);
+    writeCorridorPens(gg, edges, *corridors, corridorWidth, &enfGeoPens);
+    phases.geoPensMs = T_STOP(corrs);
+    LOGTO(DEBUG, std::cerr) << "Done. (" << phases.geoPensMs << "ms)";
+    geoPens = &enfGeoPens;
+  } else if (enfGeoPen > 0) {
     LOGTO(DEBUG, std::cerr) << "Writing geopens for " << edges.size() << " edges";
     T_START(geopens);
-    size_t i = 0;
-    for (auto cmbEdg : edges) {
-      i++;
-      LOGTO(DEBUG, std::cerr) << "@ " << i << "/" << edges.size();
-      ggs[0]->writeGeoCoursePens(cmbEdg, &enfGeoPens, enfGeoPen);
-    }
-    LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(geopens) << "ms)";
+    writeGeoPens(gg, edges, enfGeoPen, &enfGeoPens);
+    phases.geoPensMs = T_STOP(geopens);
+    LOGTO(DEBUG, std::cerr) << "Done. (" << phases.geoPensMs << "ms)";
     geoPens = &enfGeoPens;
   }
 
-  if (obstacles.size()) {
-    LOGTO(DEBUG, std::cerr) << "Writing obstacles... ";
-    T_START(obstacles);
-    for (auto gg : ggs)
-      for (const auto& obst : obstacles) gg->addObstacle(obst);
-    LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(obstacles) << "ms)";
+  Score fullScore;
+
+  try {
+    fullScore = draw(cg, gg, jobs, dOut, maxGrDist, orderMethod,
+                     restrLocSearch, obstacles, locSearchIters, abortAfter,
+                     multiMove, geoPens);
+  } catch (const NoEmbeddingFoundExc&) {
+    delete gg;
+    throw;
+  } catch (const DrawingCancelledExc&) {
+    delete gg;
+    throw;
   }
 
-  // this is the best drawing
-  Drawing drawing(ggs[0]);
+  dOut->getLineGraph(outTg);
+  *retGg = gg;
 
-  // try our default edge ordering first, without any randomization
+  fullScore.phases = fullScore.phases + phases;
+  return fullScore;
+}
+
+// _____________________________________________________________________________
+Score Octilinearizer::draw(const CombGraph& cg, BaseGraph* gg, size_t jobs,
+                           Drawing* dOut, double maxGrDist,
+                           OrderMethod orderMethod, bool restrLocSearch,
+                           const std::vector<Polygon<double>>& obstacles,
+                           size_t locSearchIters, size_t abortAfter,
+                           bool multiMove, const GeoPensMap* geoPens) {
+  auto methods = getOrderMethods(orderMethod);
+
+  LOGTO(DEBUG, std::cerr) << "Using " << jobs << " worker(s)";
 
-  std::vector<OrderMethod> methods = {
-      OrderMethod::NUM_LINES,     OrderMethod::LENGTH,
-      OrderMethod::ADJ_ND_DEGREE, OrderMethod::ADJ_ND_LDEGREE,
-      OrderMethod::GROWTH_DEG,    OrderMethod::GROWTH_LDEG};
+  PhaseStats phases;
+  size_t ndsExpanded = _ndsExpanded;
 
-  if (orderMethod != OrderMethod::ALL) {
-    methods = {orderMethod};
+  size_t LOCAL_SEARCH_ITERS = locSearchIters;
+  double CONVERGENCE_THRESHOLD = 0.05;
+
+  if (obstacles.size()) {
+    LOGTO(DEBUG, std::cerr) << "Writing obstacles... ";
+    T_START(obstacles);
+    for (const auto& obst : obstacles) gg->addObstacle(obst);
+
+    // obstacle costs are part of the grid setup
+    double obstMs = T_STOP(obstacles);
+    phases.gridMs += obstMs;
+    LOGTO(DEBUG, std::cerr) << "Done. (" << obstMs << "ms)";
   }
 
+  // the workers share gg, each routes on its own overlay. gg itself is not
+  // changed until the final drawing is applied to it.
+  std::vector<GridOverlay> ovs(jobs);
+#pragma omp parallel for
+  for (size_t i = 0; i < jobs; i++) gg->initOverlay(&ovs[i]);
+
+  // this is the best drawing
+  Drawing drawing(gg);
+
   std::vector<std::vector<OrderMethod>> batches(jobs);
   for (size_t i = 0; i < methods.size(); i++) {
     batches[i % jobs].push_back(methods[i]);
   }
 
   LOGTO(DEBUG, std::cerr) << "Searching initial drawing... ";
+  T_START(initial);
+
+  // guards the best drawing. Components may be drawn concurrently, so the
+  // lock is local to this call instead of a global omp critical section.
+  std::mutex bestMtx;
 
 #pragma omp parallel for
   for (size_t btch = 0; btch < jobs; btch++) {
+    GridOverlay::Scope ovScope(&ovs[btch]);
+
     for (OrderMethod meth : batches[btch]) {
+      if (cancelled()) break;
+
       T_START(draw);
-      Drawing drawingCp(ggs[btch]);
+      Drawing drawingCp(gg);
 
       // get a randomized ordering
       std::vector<CombEdge*> iterOrder = getOrdering(cg, meth);
 
       double bestScoreSoFar = 0;
 
-#pragma omp critical
-      { bestScoreSoFar = drawing.score(); }
+      {
+        std::lock_guard<std::mutex> lock(bestMtx);
+        bestScoreSoFar = drawing.score();
+      }
 
-      auto status = draw(iterOrder, ggs[btch], &drawingCp, bestScoreSoFar,
+      auto status = draw(iterOrder, gg, &drawingCp, bestScoreSoFar,
                          maxGrDist, geoPens, abortAfter);
 
-      drawingCp.eraseFromGrid(ggs[btch]);
+      drawingCp.eraseFromGrid(gg);
 
       statLine(status, std::string("Try ") + std::to_string(meth), drawingCp,
                T_STOP(draw), "*");
 
-#pragma omp critical
       {
+        std::lock_guard<std::mutex> lock(bestMtx);
         if (status == DRAWN && drawingCp.score() < drawing.score()) {
           drawing = drawingCp;
         } else {
@@ -225,11 +363,19 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
     }
   }
 
+  phases.initMs = T_STOP(initial);
+
+  // exceptions may not leave the parallel regions, so cancellation is only
+  // reported after them. The base graph is owned by the caller.
+  if (cancelled()) throw DrawingCancelledExc();
   if (drawing.score() == INF) throw NoEmbeddingFoundExc();
 
   LOGTO(DEBUG, std::cerr) << "Done.";
 
-  for (size_t i = 0; i < jobs; i++) drawing.applyToGrid(ggs[i]);
+  for (size_t i = 0; i < jobs; i++) {
+    GridOverlay::Scope ovScope(&ovs[i]);
+    drawing.applyToGrid(gg);
+  }
 
   size_t iters = 0;
 
@@ -240,78 +386,222 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
   // dont use local search if abortAfter is set
   if (abortAfter != std::numeric_limits<size_t>::max()) LOCAL_SEARCH_ITERS = 0;
 
-  std::vector<std::vector<CombNode*>> batchesLoc(jobs);
-  size_t c = 0;
+  // nodes with the most edges to reroute first, so that the cheap tasks
+  // are left for the end of an iteration
+  auto degCmp = [](const CombNode* a, const CombNode* b) {
+    return a->getDeg() > b->getDeg();
+  };
+
+  std::vector<CombNode*> locNds;
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
-    batchesLoc[c % jobs].push_back(nd);
-    c++;
+    locNds.push_back(nd);
   }
+  std::stable_sort(locNds.begin(), locNds.end(), degCmp);
+
+  T_START(locSearch);
 
   for (; iters < LOCAL_SEARCH_ITERS; iters++) {
     T_START(iter);
     std::vector<Drawing> bestFrIters(jobs);
 
+    // the best score found so far in this iteration by any worker, used as
+    // the limit for the shortest path computations
+    double bestFrIter = std::numeric_limits<double>::infinity();
+    std::mutex bestFrIterMtx;
+
+    // in multi move mode, the best move of every node is collected
+    std::vector<std::vector<LocSearchMove>> moves(jobs);
+
+    // every candidate position of a node is a separate task, the positions
+    // of a node are kept together
+    std::vector<LocSearchTask> tasks;
+    for (auto a : locNds) {
+      for (size_t pos = 0; pos < gg->maxDeg() + 1; pos++) {
+        auto n = gg->neigh(drawing.getGrNd(a), pos);
+        if (!n) continue;
+
+        if (restrLocSearch) {
+          // dont try positions outside the move radius for consistency with
+          // ILP approach
+          double gridD = dist(*a->pl().getGeom(), *n->pl().getGeom());
+          double maxDis = gg->getCellSize() * maxGrDist;
+          if (gridD >= maxDis) continue;
+        }
+
+        tasks.push_back({a, n->pl().getId()});
+      }
+    }
+
+    LocSearchQueue queue(tasks, jobs);
+
 #pragma omp parallel for
     for (size_t btch = 0; btch < jobs; btch++) {
-      for (auto a : batchesLoc[btch]) {
-        Drawing drawingCp = drawing;
+      GridOverlay::Scope ovScope(&ovs[btch]);
+
+      Drawing drawingCp = drawing;
+
+      // the node whose edges are currently removed from this worker's grid
+      CombNode* a = 0;
+      std::vector<CombEdge*> test;
+      LocSearchMove bestMv{0, 0, 0};
+
+      LocSearchTask task;
+
+      while (true) {
+        // on cancellation, the worker restores its node and stops
+        bool have = !cancelled() && queue.pop(btch, &task);
+
+        if (a && (!have || task.nd != a)) {
+          // done with a, restore it
+          drawingCp.rollback();
 
-        // use the batches grid graph
-        drawingCp.setBaseGraph(ggs[btch]);
+          if (bestMv.imp > 0) moves[btch].push_back(bestMv);
 
-        // reverting a
-        std::vector<CombEdge*> test;
-        for (auto ce : a->getAdjList()) {
-          test.push_back(ce);
+          gg->settleNd(const_cast<GridNode*>(drawing.getGrNd(a)), a);
 
-          drawingCp.eraseFromGrid(ce, ggs[btch]);
-          drawingCp.erase(ce);
+          // re-settle edges
+          for (auto ce : a->getAdjList()) drawing.applyToGrid(ce, gg);
+
+          a = 0;
         }
 
-        drawingCp.erase(a);
-        ggs[btch]->unSettleNd(a);
+        if (!have) break;
 
-        for (size_t pos = 0; pos < ggs[btch]->maxDeg() + 1; pos++) {
-          SettledPos p;
+        if (!a) {
+          a = task.nd;
+          bestMv = {a, 0, 0};
 
-          auto n = ggs[btch]->neigh(drawing.getGrNd(a), pos);
-          if (!n) continue;
+          // all changes to drawingCp are undone after a has been processed
+          drawingCp.checkpoint();
 
-          p[a] = n;
+          // reverting a
+          test.clear();
+          for (auto ce : a->getAdjList()) {
+            test.push_back(ce);
 
-          if (restrLocSearch) {
-            // dont try positions outside the move radius for consistency with
-            // ILP approach
-            double gridD = dist(*a->pl().getGeom(), *n->pl().getGeom());
-            double maxDis = ggs[btch]->getCellSize() * maxGrDist;
-            if (gridD >= maxDis) continue;
+            drawingCp.eraseFromGrid(ce, gg);
+            drawingCp.erase(ce);
           }
 
-          Drawing run = drawingCp;
+          drawingCp.erase(a);
+          gg->unSettleNd(a);
+        }
+
+        SettledPos p;
+        auto n = gg->getGrNdById(task.grNdId);
+        p[a] = n;
+
+        drawingCp.checkpoint();
+
+        // we can use the best score of this iteration as the limit for the
+        // shortest path computation, as we can already do at least as good.
+        // In multi move mode, only improvements for this node are of
+        // interest.
+        double limit;
+        if (multiMove) {
+          limit = drawing.score() - bestMv.imp;
+        } else {
+          std::lock_guard<std::mutex> lock(bestFrIterMtx);
+          limit = bestFrIter;
+        }
 
-          // we can use bestFromIter.score() as the limit for the shortest
-          // path computation, as we can already do at least as good.
-          auto error =
-              draw(test, p, ggs[btch], &run, bestFrIters[btch].score(),
-                   maxGrDist, geoPens, std::numeric_limits<size_t>::max());
+        auto error = draw(test, p, gg, &drawingCp, limit, maxGrDist, geoPens,
+                          std::numeric_limits<size_t>::max());
 
-          if (!error && bestFrIters[btch].score() > run.score()) {
-            bestFrIters[btch] = run;
+        if (!error && multiMove) {
+          double imp = drawing.score() - drawingCp.score();
+          if (imp > bestMv.imp) {
+            bestMv.grNdId = n->pl().getId();
+            bestMv.imp = imp;
           }
+        } else if (!error && bestFrIters[btch].score() > drawingCp.score()) {
+          bestFrIters[btch] = drawingCp;
+          std::lock_guard<std::mutex> lock(bestFrIterMtx);
+          bestFrIter = std::min(bestFrIter, drawingCp.score());
+        }
+
+        // reset grid
+        for (auto ce : a->getAdjList()) drawingCp.eraseFromGrid(ce, gg);
+        if (gg->isSettled(a)) gg->unSettleNd(a);
+
+        // only the edges rerouted for this position have to be restored
+        drawingCp.rollback();
+      }
+    }
+
+    if (cancelled()) throw DrawingCancelledExc();
+
+    if (multiMove) {
+      // commit the improving moves, best first, skipping moves whose
+      // adjacent edges overlap with an already committed move. As moves
+      // found independently may still interfere in the grid, each one is
+      // re-routed on the current drawing and only kept if it still improves.
+      std::vector<LocSearchMove> all;
+      for (const auto& btchMoves : moves) {
+        all.insert(all.end(), btchMoves.begin(), btchMoves.end());
+      }
 
-          // reset grid
-          for (auto ce : a->getAdjList()) run.eraseFromGrid(ce, ggs[btch]);
-          if (ggs[btch]->isSettled(a)) ggs[btch]->unSettleNd(a);
+      std::sort(all.begin(), all.end(),
+                [](const LocSearchMove& a, const LocSearchMove& b) {
+                  return a.imp > b.imp;
+                });
+
+      double prevScore = drawing.score();
+
+      // the moves are committed on the first overlay, the others are
+      // updated afterwards
+      for (size_t i = 1; i < jobs; i++) {
+        GridOverlay::Scope ovScope(&ovs[i]);
+        drawing.eraseFromGrid(gg);
+      }
+
+      std::set<const CombNode*> blocked;
+      std::set<CombNode*> changed;
+      size_t committed = 0;
+
+      {
+        GridOverlay::Scope ovScope(&ovs[0]);
+        for (const auto& mv : all) {
+          if (blocked.count(mv.nd)) continue;
+          if (!moveNd(mv.nd, gg->getGrNdById(mv.grNdId), gg, &drawing,
+                      maxGrDist, geoPens)) {
+            continue;
+          }
+
+          committed++;
+          blocked.insert(mv.nd);
+          changed.insert(mv.nd);
+          for (auto ce : mv.nd->getAdjList()) {
+            blocked.insert(ce->getOtherNd(mv.nd));
+            changed.insert(ce->getOtherNd(mv.nd));
+          }
         }
+      }
+
+      for (size_t i = 1; i < jobs; i++) {
+        GridOverlay::Scope ovScope(&ovs[i]);
+        drawing.applyToGrid(gg);
+      }
+
+      double imp = prevScore - drawing.score();
+      LOGTO(DEBUG, std::cerr)
+          << " ++ Iter " << iters << ", prev " << prevScore << ", next "
+          << drawing.score() << " (" << (imp >= 0 ? "+" : "") << imp << ", "
+          << committed << "/" << all.size() << " moves, " << T_STOP(iter)
+          << " ms)";
 
-        ggs[btch]->settleNd(const_cast<GridNode*>(ggs[btch]->getGrNdById(
-                                drawing.getGrNd(a)->pl().getId())),
-                            a);
+      if (imp < CONVERGENCE_THRESHOLD) break;
 
-        // re-settle edges
-        for (auto ce : a->getAdjList()) drawing.applyToGrid(ce, ggs[btch]);
+      // only nodes whose neighborhood changed are evaluated in the next sweep
+      locNds.clear();
+      for (auto nd : changed) {
+        if (nd->getDeg() == 0) continue;
+        locNds.push_back(nd);
       }
+      std::stable_sort(locNds.begin(), locNds.end(), degCmp);
+
+      continue;
     }
 
     size_t bestCore = 0;
@@ -330,15 +620,17 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
         << ", " << T_STOP(iter) << " ms)";
 
     for (size_t i = 0; i < jobs; i++) {
-      drawing.eraseFromGrid(ggs[i]);
-      bestFrIters[bestCore].applyToGrid(ggs[i]);
+      GridOverlay::Scope ovScope(&ovs[i]);
+      drawing.eraseFromGrid(gg);
+      bestFrIters[bestCore].applyToGrid(gg);
     }
     drawing = bestFrIters[bestCore];
 
     if (imp < CONVERGENCE_THRESHOLD) break;
   }
 
-  drawing.getLineGraph(outTg);
+  phases.locSearchMs = T_STOP(locSearch);
+
   auto fullScore = drawing.fullScore();
   LOGTO(DEBUG, std::cerr) << "Topo violations: " << drawing.violations()
                           << ", hop costs: " << fullScore.hop
@@ -346,16 +638,287 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
                           << ", mv costs: " << fullScore.move
                           << ", dense costs: " << fullScore.dense;
 
-  *retGg = ggs[0];
+  // the overlays are dropped, the final drawing is applied to gg itself
+  drawing.applyToGrid(gg);
+
+  *dOut = drawing;
+
+  fullScore.iters = iters;
+  fullScore.phases = phases;
+  fullScore.phases.ndsExpanded = _ndsExpanded - ndsExpanded;
+  return fullScore;
+}
+
+// _____________________________________________________________________________
+Score Octilinearizer::drawMultiLevel(
+    const CombGraph& cg, const DBox& box, LineGraph* outTg, BaseGraph** retGg,
+    Drawing* dOut, const Penalties& pens, double gridSize, double borderRad,
+    double maxGrDist, OrderMethod orderMethod, bool restrLocSearch,
+    double enfGeoPen, size_t hananIters,
+    const std::vector<Polygon<double>>& obstacles, size_t locSearchIters,
+    size_t abortAfter, size_t jobs, bool multiMove, size_t levels) {
+  // each level only routes in a corridor of 2 * maxGrDist of its cells around
+  // the solution of the next coarser level, which covers the max station
+  // displacement there
+  EdgeCorridors corridors;
+
+  // the phases of the coarser levels are added to the final score
+  PhaseStats lvlPhases;
+
+  for (size_t lvl = levels - 1; lvl > 0; lvl--) {
+    // each coarser level doubles the grid size
+    double lvlGridSize = gridSize * (1 << lvl);
+    auto lvlBox = util::geo::pad(box, lvlGridSize - gridSize);
+
+    LOGTO(DEBUG, std::cerr) << "Level " << lvl << ", grid size "
+                            << lvlGridSize;
+
+    LineGraph lvlOut;
+    BaseGraph* lvlGg;
+    Drawing lvlD;
+
+    try {
+      auto lvlScore = draw(cg, lvlBox, &lvlOut, &lvlGg, &lvlD, pens,
+                           lvlGridSize, borderRad, maxGrDist, orderMethod,
+                           restrLocSearch, enfGeoPen, hananIters, obstacles,
+                           locSearchIters, abortAfter, jobs, multiMove,
+                           corridors.empty() ? 0 : &corridors, 2 * maxGrDist);
+      lvlPhases = lvlPhases + lvlScore.phases;
+    } catch (const NoEmbeddingFoundExc&) {
+      // keep the corridors of the previous level, if any
+      LOGTO(INFO, std::cerr) << "No embedding found on level " << lvl
+                             << ", continuing on next finer level";
+      continue;
+    }
+
+    corridors.clear();
+    for (const auto& path : lvlD.getEdgPaths()) {
+      corridors[path.first] = lvlGg->geomFromPath(path.second).getLine();
+    }
+
+    delete lvlGg;
+  }
+
+  LOGTO(DEBUG, std::cerr) << "Level 0, grid size " << gridSize;
+  auto score = draw(cg, box, outTg, retGg, dOut, pens, gridSize, borderRad,
+                    maxGrDist, orderMethod, restrLocSearch, enfGeoPen,
+                    hananIters, obstacles, locSearchIters, abortAfter, jobs,
+                    multiMove, corridors.empty() ? 0 : &corridors,
+                    2 * maxGrDist);
+  score.phases = score.phases + lvlPhases;
+  return score;
+}
+
+// _____________________________________________________________________________
+Score Octilinearizer::drawIncremental(
+    const CombGraph& cg, const DBox& box, const LineGraph& prev,
+    LineGraph* outTg, BaseGraph** retGg, Drawing* dOut, const Penalties& pens,
+    double gridSize, double borderRad, double maxGrDist,
+    OrderMethod orderMethod, bool restrLocSearch, double enfGeoPen,
+    size_t hananIters, const std::vector<Polygon<double>>& obstacles,
+    size_t locSearchIters, size_t abortAfter, size_t jobs, bool multiMove) {
+  PrevDrawing prevD(&prev);
+  prevD.match(cg, (maxGrDist + 1) * gridSize);
+
+  PhaseStats phases;
+  size_t ndsExpanded = _ndsExpanded;
+
+  BaseGraph* gg = 0;
+  phases.gridMs =
+      buildBaseGraph(box, cg, gridSize, borderRad, hananIters, pens, &gg);
+
+  T_START(obstacles);
+  for (const auto& obst : obstacles) gg->addObstacle(obst);
+  phases.gridMs += T_STOP(obstacles);
+
+  // matched nodes are fixed to the grid node nearest to their previous
+  // position. If the grid moved since, they snap to the new grid.
+  SettledPos fixed;
+  std::set<const GridNode*> used;
+  for (auto nd : cg.getNds()) {
+    auto pos = prevD.getPos(nd);
+    if (!pos) continue;
+
+    const GridNode* best = 0;
+    for (auto cand : gg->getGridNdsInRad(*pos, gg->getCellSize())) {
+      if (used.count(cand)) continue;
+      if (!best || dist(*cand->pl().getGeom(), *pos) <
+                       dist(*best->pl().getGeom(), *pos)) {
+        best = cand;
+      }
+    }
+
+    if (!best) continue;
+    used.insert(best);
+    fixed[nd] = best;
+  }
+
+  std::vector<CombEdge*> unchanged, changed;
+  EdgeCorridors prevGeoms;
+
+  for (auto e : getOrdering(cg, OrderMethod::NUM_LINES)) {
+    auto geom = prevD.getGeom(e);
+    if (geom && fixed.count(e->getFrom()) && fixed.count(e->getTo())) {
+      unchanged.push_back(e);
+      prevGeoms[e] = *geom;
+    } else {
+      changed.push_back(e);
+    }
+  }
+
+  LOGTO(DEBUG, std::cerr) << "Keeping " << unchanged.size() << " edges, "
+                          << "rerouting " << changed.size() << " edges";
+
+  // unchanged edges are kept in a corridor of one cell around their previous
+  // course, changed edges get the usual geo pens, if any
+  T_START(geopens);
+  GeoPensMap geoPens;
+  writeCorridorPens(gg, unchanged, prevGeoms, 1, &geoPens);
+  if (enfGeoPen > 0) writeGeoPens(gg, changed, enfGeoPen, &geoPens);
+  phases.geoPensMs = T_STOP(geopens);
+
+  Drawing drawing(gg);
+
+  double inf = std::numeric_limits<double>::infinity();
+  size_t noAbort = std::numeric_limits<size_t>::max();
+
+  T_START(initial);
+  auto status =
+      draw(unchanged, fixed, gg, &drawing, inf, maxGrDist, &geoPens, noAbort);
+  if (status == DRAWN) {
+    status =
+        draw(changed, fixed, gg, &drawing, inf, maxGrDist, &geoPens, noAbort);
+  }
+  phases.initMs = T_STOP(initial);
+
+  if (status == CANCELLED) {
+    delete gg;
+    throw DrawingCancelledExc();
+  }
+
+  if (status != DRAWN) {
+    LOGTO(INFO, std::cerr)
+        << "Could not keep previous drawing, drawing from scratch";
+    delete gg;
+    phases.ndsExpanded = _ndsExpanded - ndsExpanded;
+    auto score = draw(cg, box, outTg, retGg, dOut, pens, gridSize, borderRad,
+                      maxGrDist, orderMethod, restrLocSearch, enfGeoPen,
+                      hananIters, obstacles, locSearchIters, abortAfter, jobs,
+                      multiMove, 0, 0);
+    score.phases = score.phases + phases;
+    return score;
+  }
+
+  LOGTO(DEBUG, std::cerr) << "Initial score: " << drawing.score() << " ("
+                          << drawing.violations() << " topology violations).";
+
+  // local search, only on the nodes of changed edges
+  std::set<CombNode*> area;
+  for (auto e : changed) {
+    area.insert(e->getFrom());
+    area.insert(e->getTo());
+  }
+
+  size_t iters = 0;
+
+  T_START(locSearch);
+
+  for (; iters < locSearchIters && area.size(); iters++) {
+    if (cancelled()) {
+      delete gg;
+      throw DrawingCancelledExc();
+    }
+
+    T_START(iter);
+    double prevScore = drawing.score();
+    size_t moved = 0;
+
+    for (auto nd : area) {
+      auto cur = drawing.getGrNd(nd);
+
+      for (size_t pos = 0; pos < gg->maxDeg(); pos++) {
+        auto n = gg->neigh(cur, pos);
+        if (!n || n == cur) continue;
+
+        if (restrLocSearch) {
+          // dont try positions outside the move radius
+          double gridD = dist(*nd->pl().getGeom(), *n->pl().getGeom());
+          if (gridD >= gg->getCellSize() * maxGrDist) continue;
+        }
+
+        if (moveNd(nd, n, gg, &drawing, maxGrDist, &geoPens)) {
+          moved++;
+          break;
+        }
+      }
+    }
+
+    double imp = prevScore - drawing.score();
+    LOGTO(DEBUG, std::cerr) << " ++ Iter " << iters << ", prev " << prevScore
+                            << ", next " << drawing.score() << " (+" << imp
+                            << ", " << moved << " moves, " << T_STOP(iter)
+                            << " ms)";
+
+    if (!moved) break;
+  }
+
+  phases.locSearchMs = T_STOP(locSearch);
+
+  drawing.getLineGraph(outTg);
+  auto fullScore = drawing.fullScore();
+
+  *retGg = gg;
   *dOut = drawing;
 
-  // the drawing might still have another internal grid graph, make sure they
-  // match (this is important for drawILP)
-  dOut->setBaseGraph(ggs[0]);
   fullScore.iters = iters;
+  fullScore.phases = phases;
+  fullScore.phases.ndsExpanded = _ndsExpanded - ndsExpanded;
   return fullScore;
 }
 
+// _____________________________________________________________________________
+bool Octilinearizer::moveNd(CombNode* nd, GridNode* to, BaseGraph* gg,
+                            Drawing* drawing, double maxGrDist,
+                            const GeoPensMap* geoPensMap) {
+  double prevScore = drawing->score();
+  auto from = gg->getGrNdById(drawing->getGrNd(nd)->pl().getId());
+
+  drawing->checkpoint();
+
+  std::vector<CombEdge*> test;
+  for (auto ce : nd->getAdjList()) {
+    test.push_back(ce);
+
+    drawing->eraseFromGrid(ce, gg);
+    drawing->erase(ce);
+  }
+
+  drawing->erase(nd);
+  gg->unSettleNd(nd);
+
+  SettledPos p;
+  p[nd] = to;
+
+  auto error = draw(test, p, gg, drawing, prevScore, maxGrDist, geoPensMap,
+                    std::numeric_limits<size_t>::max());
+
+  if (!error && drawing->score() < prevScore) {
+    drawing->commit();
+    return true;
+  }
+
+  // restore the previous position
+  for (auto ce : nd->getAdjList()) drawing->eraseFromGrid(ce, gg);
+  if (gg->isSettled(nd)) gg->unSettleNd(nd);
+
+  drawing->rollback();
+
+  gg->settleNd(from, nd);
+  for (auto ce : nd->getAdjList()) drawing->applyToGrid(ce, gg);
+
+  return false;
+}
+
 // _____________________________________________________________________________
 void Octilinearizer::settleRes(GridNode* frGrNd, GridNode* toGrNd,
                                BaseGraph* gg, CombNode* from, CombNode* to,
@@ -403,6 +966,8 @@ Undrawable Octilinearizer::draw(const std::vector<CombEdge*>& ord,
   size_t i = 0;
 
   for (auto cmbEdg : ord) {
+    if (cancelled()) return CANCELLED;
+
     double cutoff = globCutoff - drawing->score();
     i++;
     if (drawing->score() == std::numeric_limits<double>::infinity()) {
@@ -482,16 +1047,31 @@ Undrawable Octilinearizer::draw(const std::vector<CombEdge*>& ord,
 
     auto heur = gg->getHeur(toGrNds);
 
+    // edges without an entry in the geo pens map are routed without them
+    const GeoPens* geoPens = 0;
     if (geoPensMap) {
+      auto it = geoPensMap->find(cmbEdg);
+      if (it != geoPensMap->end()) geoPens = &it->second;
+    }
+
+    size_t expanded = router()->expanded();
+
+    if (geoPens) {
       // init cost function with geo distance penalties
-      auto cost = GridCostGeoPen(cutoff + costOffsetTo + costOffsetFrom,
-                                 &geoPensMap->find(cmbEdg)->second);
-      Dijkstra::shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL);
+      auto cost =
+          GridCostGeoPen(cutoff + costOffsetTo + costOffsetFrom, geoPens);
+      router()->shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL,
+                             gg->getLandmarks());
     } else {
       auto cost = GridCost(cutoff + costOffsetTo + costOffsetFrom);
-      Dijkstra::shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL);
+      router()->shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL,
+                             gg->getLandmarks());
     }
 
+    expanded = router()->expanded() - expanded;
+#pragma omp atomic
+    _ndsExpanded += expanded;
+
     delete heur;
 
     if (!nL.size()) {
@@ -625,6 +1205,49 @@ std::set<GridNode*> Octilinearizer::getCands(CombNode* cmbNd,
   return ret;
 }
 
+// _____________________________________________________________________________
+size_t Octilinearizer::numWorkers(const CombGraph& cg,
+                                  OrderMethod orderMethod,
+                                  size_t locSearchIters, size_t abortAfter,
+                                  size_t jobs) const {
+  if (jobs == 0) {
+    jobs = std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  // every worker needs its own overlay, don't build more of them than there
+  // is parallel work for
+  size_t maxPar = getOrderMethods(orderMethod).size();
+  if (abortAfter == std::numeric_limits<size_t>::max() && locSearchIters > 0) {
+    size_t locSearchNds = 0;
+    for (auto nd : cg.getNds())
+      if (nd->getDeg() > 0) locSearchNds++;
+    maxPar = std::max(maxPar, locSearchNds);
+  }
+  return std::max<size_t>(1, std::min(jobs, maxPar));
+}
+
+// _____________________________________________________________________________
+double Octilinearizer::buildBaseGraph(const DBox& box, const CombGraph& cg,
+                                      double gridSize, double borderRad,
+                                      size_t hananIters, const Penalties& pens,
+                                      BaseGraph** gg) const {
+  LOGTO(DEBUG, std::cerr) << "Creating grid graph... ";
+  T_START(ggraph);
+  *gg = newBaseGraph(box, cg, gridSize, borderRad, hananIters, pens);
+  (*gg)->init();
+
+  if (_numLandmarks) {
+    (*gg)->setLandmarks(std::make_shared<GridLandmarks>(*gg, _numLandmarks));
+  }
+
+  double ms = T_STOP(ggraph);
+  LOGTO(DEBUG, std::cerr) << "Done. (" << ms << "ms)";
+
+  LOGTO(DEBUG, std::cerr) << "Grid graph has " << (*gg)->getNds().size()
+                          << " nodes";
+  return ms;
+}
+
 // _____________________________________________________________________________
 BaseGraph* Octilinearizer::newBaseGraph(const DBox& bbox, const CombGraph& cg,
                                         double cellSize, double spacer,
@@ -681,9 +1304,26 @@ void Octilinearizer::statLine(Undrawable status, const std::string& msg,
                               << " <no cands>"
                               << " (" << ms << " ms)" << mark;
       break;
+    case CANCELLED:
+      LOGTO(DEBUG, std::cerr) << " ++ " << msg << ", score <inf>"
+                              << " <cancelled>"
+                              << " (" << ms << " ms)" << mark;
+      break;
   }
 }
 
+// _____________________________________________________________________________
+void Octilinearizer::setCancel(const std::atomic<size_t>* best,
+                               size_t attempt) {
+  _cancelBest = best;
+  _cancelAttempt = attempt;
+}
+
+// _____________________________________________________________________________
+bool Octilinearizer::cancelled() const {
+  return _cancelBest && *_cancelBest < _cancelAttempt;
+}
+
 // _____________________________________________________________________________
 size_t Octilinearizer::maxNodeDeg() const {
   // TODO: this is currently at two locations, in the base graph class and here,
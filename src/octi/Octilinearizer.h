@@ -5,6 +5,7 @@
 #ifndef OCTI_OCTILINEARIZER_H_
 #define OCTI_OCTILINEARIZER_H_
 
+#include <atomic>
 #include <unordered_set>
 #include <vector>
 
@@ -40,6 +41,7 @@ using octi::combgraph::CombNode;
 using octi::combgraph::Drawing;
 using octi::combgraph::EdgeOrdering;
 
+using octi::combgraph::PhaseStats;
 using octi::combgraph::Score;
 
 using util::graph::Dijkstra;
@@ -49,7 +51,18 @@ typedef util::graph::NList<GridNodePL, GridEdgePL> GrNdList;
 typedef std::pair<std::set<GridNode*>, std::set<GridNode*>> RtPair;
 typedef std::map<CombNode*, const GridNode*> SettledPos;
 
-enum Undrawable { DRAWN = 0, NO_PATH = 1, NO_CANDS = 2 };
+// geometry of a coarser solution for each comb edge, finer levels only route
+// in a corridor around it
+typedef std::map<const CombEdge*, util::geo::DLine> EdgeCorridors;
+
+enum Undrawable { DRAWN = 0, NO_PATH = 1, NO_CANDS = 2, CANCELLED = 3 };
+
+// an improving node move found during local search
+struct LocSearchMove {
+  CombNode* nd;
+  size_t grNdId;
+  double imp;
+};
 
 // exception thrown when no planar embedding could be found
 struct NoEmbeddingFoundExc : public std::exception {
@@ -58,6 +71,11 @@ struct NoEmbeddingFoundExc : public std::exception {
   }
 };
 
+// exception thrown when a drawing was cancelled, see setCancel()
+struct DrawingCancelledExc : public std::exception {
+  const char* what() const throw() { return "Drawing was cancelled."; }
+};
+
 // comparator for nodes, based on degree
 struct NodeCmpDeg {
   bool operator()(const CombNode* a, const CombNode* b) {
@@ -157,11 +175,9 @@ struct GridCostGeoPen
     // ignore geopens for secondary edges
     if (e->pl().isSecondary()) return e->pl().cost();
 
-    auto i = (*_geoPens).find(e->pl().getId());
-    if (i != _geoPens->end()) return e->pl().cost() + i->second;
-
     // if no geopen was present for grid edge, we assume SOFT_INF penalty
-    return e->pl().cost() + octi::basegraph::SOFT_INF;
+    return e->pl().cost() +
+           _geoPens->get(e->pl().getId(), octi::basegraph::SOFT_INF);
   }
 
   float _inf;
@@ -172,8 +188,17 @@ struct GridCostGeoPen
 
 class Octilinearizer {
  public:
-  Octilinearizer(basegraph::BaseGraphType baseGraphType)
-      : _baseGraphType(baseGraphType) {}
+  Octilinearizer(basegraph::BaseGraphType baseGraphType, size_t numLandmarks)
+      : _baseGraphType(baseGraphType),
+        _numLandmarks(numLandmarks),
+        _ndsExpanded(0),
+        _cancelBest(0),
+        _cancelAttempt(0) {}
+
+  // cancel all drawing as soon as *best drops below attempt. Checked between
+  // the routed edges and the local search tasks, the draw methods then throw
+  // a DrawingCancelledExc.
+  void setCancel(const std::atomic<size_t>* best, size_t attempt);
 
   Score draw(const CombGraph& cg, const util::geo::DBox& box, LineGraph* out,
              basegraph::BaseGraph** gg, Drawing* d, const Penalties& pens,
@@ -181,27 +206,74 @@ class Octilinearizer {
              config::OrderMethod orderMethod, bool restrLocSearch,
              double enfGeoCourse, size_t hananIters,
              const std::vector<util::geo::Polygon<double>>& obstacles,
-             size_t locsearchIters, size_t abortAfter);
+             size_t locsearchIters, size_t abortAfter, size_t jobs,
+             bool multiMove, const EdgeCorridors* corridors,
+             double corridorWidth);
+
+  Score drawMultiLevel(
+      const CombGraph& cg, const util::geo::DBox& box, LineGraph* out,
+      basegraph::BaseGraph** gg, Drawing* d, const Penalties& pens,
+      double gridSize, double borderRad, double maxGrDist,
+      config::OrderMethod orderMethod, bool restrLocSearch,
+      double enfGeoCourse, size_t hananIters,
+      const std::vector<util::geo::Polygon<double>>& obstacles,
+      size_t locsearchIters, size_t abortAfter, size_t jobs, bool multiMove,
+      size_t levels);
+
+  Score drawIncremental(
+      const CombGraph& cg, const util::geo::DBox& box, const LineGraph& prev,
+      LineGraph* out, basegraph::BaseGraph** gg, Drawing* d,
+      const Penalties& pens, double gridSize, double borderRad,
+      double maxGrDist, config::OrderMethod orderMethod, bool restrLocSearch,
+      double enfGeoCourse, size_t hananIters,
+      const std::vector<util::geo::Polygon<double>>& obstacles,
+      size_t locsearchIters, size_t abortAfter, size_t jobs, bool multiMove);
 
   Score drawILP(const CombGraph& cg, const util::geo::DBox& box, LineGraph* out,
                 basegraph::BaseGraph** gg, Drawing* d, const Penalties& pens,
                 double gridSize, double borderRad, double maxGrDist,
                 config::OrderMethod orderMethod, bool noSolve,
-                double enfGeoPens, size_t hananIters, int timeLim,
+                double enfGeoPens, size_t hananIters, size_t jobs, int timeLim,
                 const std::string& cacheDir, double cacheThreshold,
-                int numThreads, octi::ilp::ILPStats* stats,
-                const std::string& solverStr, const std::string& path);
+                int numThreads, double relGap, double corridor,
+                double window, octi::ilp::ILPStats* stats,
+                const std::string& solverStr,
+                const std::string& solverProfile, const std::string& path);
 
   size_t maxNodeDeg() const;
 
  private:
   basegraph::BaseGraphType _baseGraphType;
 
+  // ALT landmarks per base graph, 0 disables them
+  size_t _numLandmarks;
+
+  // grid nodes expanded by the shortest path searches of all workers
+  size_t _ndsExpanded;
+
+  const std::atomic<size_t>* _cancelBest;
+  size_t _cancelAttempt;
+
+  bool cancelled() const;
+
   basegraph::BaseGraph* newBaseGraph(const util::geo::DBox& bbox,
                                      const CombGraph& cg, double cellSize,
                                      double spacer, size_t hananIters,
                                      const Penalties& pens) const;
 
+  // builds and initializes a base graph and its landmarks into gg, returns
+  // the time taken in ms
+  double buildBaseGraph(const util::geo::DBox& bbox, const CombGraph& cg,
+                        double cellSize, double spacer, size_t hananIters,
+                        const Penalties& pens,
+                        basegraph::BaseGraph** gg) const;
+
+  // number of heuristic workers, each of which routes on its own overlay of
+  // the base graph. 0 means one per core.
+  size_t numWorkers(const CombGraph& cg, config::OrderMethod orderMethod,
+                    size_t locSearchIters, size_t abortAfter,
+                    size_t jobs) const;
+
   util::geo::Polygon<double> hull(const CombGraph& cg) const;
 
   void writeNdCosts(GridNode* n, CombNode* origNode, CombEdge* e,
@@ -216,6 +288,16 @@ class Octilinearizer {
   std::vector<CombEdge*> getOrdering(const CombGraph& cg,
                                      octi::config::OrderMethod method) const;
 
+  // heuristic drawing on an already built base graph with jobs workers, each
+  // routing on its own overlay of gg. The result is applied to gg, which is
+  // not deleted, not even on failure.
+  Score draw(const CombGraph& cg, basegraph::BaseGraph* gg, size_t jobs,
+             Drawing* d, double maxGrDist, config::OrderMethod orderMethod,
+             bool restrLocSearch,
+             const std::vector<util::geo::Polygon<double>>& obstacles,
+             size_t locsearchIters, size_t abortAfter, bool multiMove,
+             const GeoPensMap* geoPensMap);
+
   Undrawable draw(const std::vector<CombEdge*>& order, basegraph::BaseGraph* gg,
                   Drawing* drawing, double cutoff, double maxGrDist,
                   const GeoPensMap* geoPensMap, size_t abortAfter);
@@ -227,6 +309,10 @@ class Octilinearizer {
   SettledPos neigh(const SettledPos& pos, const std::vector<CombNode*>&,
                    size_t i) const;
 
+  bool moveNd(CombNode* nd, GridNode* to, basegraph::BaseGraph* gg,
+              Drawing* drawing, double maxGrDist,
+              const GeoPensMap* geoPensMap);
+
   RtPair getRtPair(CombNode* frCmbNd, CombNode* toCmbNd,
                    const SettledPos& settled, basegraph::BaseGraph* gg,
                    double maxGrDist);
@@ -0,0 +1,166 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include "octi/PrevDrawing.h"
+#include "util/log/Log.h"
+
+using octi::PrevDrawing;
+using octi::combgraph::CombEdge;
+using octi::combgraph::CombGraph;
+using octi::combgraph::CombNode;
+using shared::linegraph::LineEdge;
+using shared::linegraph::LineNode;
+using util::geo::dist;
+using util::geo::DLine;
+using util::geo::DPoint;
+
+// _____________________________________________________________________________
+void PrevDrawing::match(const CombGraph& cg, double maxD) {
+  _nds.clear();
+  _edgs.clear();
+
+  std::map<std::string, const LineNode*> prevStats;
+  std::vector<const LineNode*> prevNonStats;
+
+  for (auto nd : _prev->getNds()) {
+    if (nd->pl().stops().size()) {
+      prevStats[nd->pl().stops().front().id] = nd;
+    } else {
+      prevNonStats.push_back(nd);
+    }
+  }
+
+  std::set<const LineNode*> matched;
+
+  for (auto nd : cg.getNds()) {
+    auto ln = nd->pl().getParent();
+    const LineNode* m = 0;
+
+    if (ln->pl().stops().size()) {
+      auto it = prevStats.find(ln->pl().stops().front().id);
+      if (it != prevStats.end()) m = it->second;
+    } else {
+      auto lines = getLines(ln);
+      double best = maxD;
+      for (auto cand : prevNonStats) {
+        if (matched.count(cand)) continue;
+        double d = dist(*cand->pl().getGeom(), *nd->pl().getGeom());
+        if (d >= best || getLines(cand) != lines) continue;
+        best = d;
+        m = cand;
+      }
+    }
+
+    if (!m || matched.count(m)) continue;
+    if (dist(*m->pl().getGeom(), *nd->pl().getGeom()) >= maxD) continue;
+
+    matched.insert(m);
+    _nds[nd] = m;
+  }
+
+  for (auto nd : cg.getNds()) {
+    for (auto e : nd->getAdjList()) {
+      if (e->getFrom() != nd) continue;
+
+      auto a = _nds.find(e->getFrom());
+      auto b = _nds.find(e->getTo());
+      if (a == _nds.end() || b == _nds.end()) continue;
+
+      // lines and inner stations of the comb edge
+      std::set<std::string> lines, stations;
+      for (auto child : e->pl().getChilds()) {
+        for (const auto& lo : child->pl().getLines()) {
+          lines.insert(lo.line->id());
+        }
+
+        for (auto lnd : {child->getFrom(), child->getTo()}) {
+          if (lnd == e->getFrom()->pl().getParent() ||
+              lnd == e->getTo()->pl().getParent()) {
+            continue;
+          }
+          if (lnd->pl().stops().size()) {
+            stations.insert(lnd->pl().stops().front().id);
+          }
+        }
+      }
+
+      DLine geom;
+      if (chain(a->second, b->second, lines, stations, matched, &geom)) {
+        _edgs[e] = geom;
+      }
+    }
+  }
+
+  LOGTO(DEBUG, std::cerr) << "Matched " << _nds.size() << " of "
+                          << cg.getNds().size() << " nodes and "
+                          << _edgs.size() << " edges to previous drawing";
+}
+
+// _____________________________________________________________________________
+bool PrevDrawing::chain(const LineNode* a, const LineNode* b,
+                        const std::set<std::string>& lines,
+                        const std::set<std::string>& stations,
+                        const std::set<const LineNode*>& matched,
+                        DLine* geom) const {
+  for (auto start : a->getAdjList()) {
+    std::set<std::string> chLines, chStations;
+    DLine chGeom;
+
+    const LineEdge* e = start;
+    const LineNode* cur = a;
+
+    while (true) {
+      for (const auto& lo : e->pl().getLines()) chLines.insert(lo.line->id());
+
+      auto l = *e->pl().getGeom();
+      if (e->getFrom() != cur) std::reverse(l.begin(), l.end());
+      chGeom.insert(chGeom.end(), l.begin(), l.end());
+
+      cur = e->getOtherNd(cur);
+
+      // the chain ends at the next node which is itself a comb node image
+      if (cur == a || cur == b || cur->getDeg() != 2 || matched.count(cur)) {
+        break;
+      }
+
+      if (cur->pl().stops().size()) {
+        chStations.insert(cur->pl().stops().front().id);
+      }
+
+      e = cur->getAdjList().front() == e ? cur->getAdjList().back()
+                                         : cur->getAdjList().front();
+    }
+
+    if (cur == b && chLines == lines && chStations == stations) {
+      *geom = chGeom;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// _____________________________________________________________________________
+std::set<std::string> PrevDrawing::getLines(const LineNode* nd) {
+  std::set<std::string> ret;
+  for (auto e : nd->getAdjList()) {
+    for (const auto& lo : e->pl().getLines()) ret.insert(lo.line->id());
+  }
+  return ret;
+}
+
+// _____________________________________________________________________________
+const DPoint* PrevDrawing::getPos(const CombNode* nd) const {
+  auto it = _nds.find(nd);
+  if (it == _nds.end()) return 0;
+  return it->second->pl().getGeom();
+}
+
+// _____________________________________________________________________________
+const DLine* PrevDrawing::getGeom(const CombEdge* e) const {
+  auto it = _edgs.find(e);
+  if (it == _edgs.end()) return 0;
+  return &it->second;
+}
@@ -0,0 +1,55 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_PREVDRAWING_H_
+#define OCTI_PREVDRAWING_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include "octi/combgraph/CombGraph.h"
+#include "shared/linegraph/LineGraph.h"
+#include "util/geo/Geo.h"
+
+namespace octi {
+
+// Matches a comb graph against a previous octi output. Station nodes are
+// matched by their station id, all other nodes to the nearest previous
+// non-station node with the same adjacent lines. A comb edge is unchanged if
+// both of its nodes were matched and the previous output connects them by a
+// chain of degree 2 nodes carrying the same lines and stations.
+class PrevDrawing {
+ public:
+  explicit PrevDrawing(const shared::linegraph::LineGraph* prev)
+      : _prev(prev) {}
+
+  // only match nodes whose previous position is closer than maxD
+  void match(const octi::combgraph::CombGraph& cg, double maxD);
+
+  // the previous position of nd, or 0 if nd was not matched
+  const util::geo::DPoint* getPos(const octi::combgraph::CombNode* nd) const;
+
+  // the previous course of e, or 0 if e changed
+  const util::geo::DLine* getGeom(const octi::combgraph::CombEdge* e) const;
+
+ private:
+  const shared::linegraph::LineGraph* _prev;
+
+  std::map<const octi::combgraph::CombNode*, const shared::linegraph::LineNode*>
+      _nds;
+  std::map<const octi::combgraph::CombEdge*, util::geo::DLine> _edgs;
+
+  static std::set<std::string> getLines(const shared::linegraph::LineNode* nd);
+
+  bool chain(const shared::linegraph::LineNode* a,
+             const shared::linegraph::LineNode* b,
+             const std::set<std::string>& lines,
+             const std::set<std::string>& stations,
+             const std::set<const shared::linegraph::LineNode*>& matched,
+             util::geo::DLine* geom) const;
+};
+
+}  // namespace octi
+
+#endif  // OCTI_PREVDRAWING_H_
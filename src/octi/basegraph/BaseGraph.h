@@ -4,9 +4,11 @@
 #ifndef OCTI_BASEGRAPH_BASEGRAPH_H_
 #define OCTI_BASEGRAPH_BASEGRAPH_H_
 
+#include <memory>
 #include <queue>
 #include <set>
 #include <unordered_map>
+#include "octi/basegraph/GeoPens.h"
 #include "octi/basegraph/GridEdgePL.h"
 #include "octi/basegraph/GridNodePL.h"
 #include "octi/basegraph/NodeCost.h"
@@ -43,16 +45,20 @@ enum BaseGraphType {
   OCTIQUADTREE
 };
 
+class GridLandmarks;
+class GridOverlay;
+
 typedef util::graph::Node<GridNodePL, GridEdgePL> GridNode;
 typedef util::graph::Edge<GridNodePL, GridEdgePL> GridEdge;
 
 typedef std::pair<const GridEdge*, const GridEdge*> EdgPair;
 typedef std::vector<std::pair<EdgPair, EdgPair>> CrossEdgPairs;
 
-// edge-id -> pen
-typedef std::unordered_map<uint32_t, float> GeoPens;
 typedef std::map<const CombEdge*, GeoPens> GeoPensMap;
 
+// grid edges blocked by obstacles, as pairs of grid node ids
+typedef std::vector<std::pair<size_t, size_t>> ObstEdgs;
+
 struct Candidate {
   Candidate(GridNode* n, double d) : n(n), d(d){};
 
@@ -96,6 +102,11 @@ class BaseGraph : public DirGraph<GridNodePL, GridEdgePL> {
   virtual std::priority_queue<Candidate> getGridNdCands(
       const util::geo::DPoint& p, size_t maxGrD) const = 0;
 
+  // all grid nodes (regardless of their state) closer than maxD to p, ordered
+  // by id
+  virtual std::vector<GridNode*> getGridNdsInRad(const util::geo::DPoint& p,
+                                                 double maxD) const = 0;
+
   virtual void addCostVec(GridNode* n, const NodeCost& addC) = 0;
 
   virtual void openSinkTo(GridNode* n, double cost) = 0;
@@ -138,12 +149,30 @@ class BaseGraph : public DirGraph<GridNodePL, GridEdgePL> {
   virtual std::set<CombEdge*> getResEdgs(const GridEdge* ge) const = 0;
   virtual std::set<CombEdge*> getResEdgsDirInd(const GridEdge* ge) const = 0;
 
-  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
-                                  double pen) = 0;
+  // write the geo course penalties of ce into target, must be safe to call
+  // concurrently for different targets
+  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPens* target,
+                                  double pen) const = 0;
+
+  // write zero penalties for all grid edges within width cells of one of
+  // geoms into target, all other grid edges get the default SOFT_INF penalty
+  virtual void writeCorridorPens(const std::vector<util::geo::DLine>& geoms,
+                                 GeoPens* target, double width) const = 0;
 
   virtual CrossEdgPairs getCrossEdgPairs() const = 0;
 
   virtual void addObstacle(const util::geo::Polygon<double>& obst) = 0;
+
+  // ALT landmarks for the shortest path searches, or null. They are computed
+  // once on the unsettled graph.
+  virtual const GridLandmarks* getLandmarks() const = 0;
+  virtual void setLandmarks(std::shared_ptr<const GridLandmarks> lms) = 0;
+
+  // copies the current routing state of the graph (not of an active overlay)
+  // into ov, after which ov can be activated to route on the graph without
+  // changing it
+  virtual void initOverlay(GridOverlay* ov) const = 0;
+
   virtual PolyLine<double> geomFromPath(
       const std::vector<std::pair<size_t, size_t>>& res) const = 0;
 };
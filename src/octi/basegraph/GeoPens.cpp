@@ -0,0 +1,41 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <limits>
+#include "octi/basegraph/GeoPens.h"
+
+using octi::basegraph::GeoPens;
+
+// _____________________________________________________________________________
+void GeoPens::add(uint32_t id, float pen) { _pending.push_back({id, pen}); }
+
+// _____________________________________________________________________________
+void GeoPens::build() {
+  std::sort(_pending.begin(), _pending.end());
+
+  _tiles.clear();
+  _vals.clear();
+  _size = 0;
+
+  for (const auto& p : _pending) {
+    uint32_t t = p.first >> TILE_BITS;
+    if (_tiles.empty() || _tiles.back() != t) {
+      _tiles.push_back(t);
+      _vals.resize(_vals.size() + TILE_MASK + 1,
+                   std::numeric_limits<float>::infinity());
+    }
+
+    size_t slot = (_tiles.size() - 1) << TILE_BITS;
+    float& v = _vals[slot | (p.first & TILE_MASK)];
+
+    // pending penalties are sorted, for duplicate ids the first one is the
+    // smallest
+    if (v != std::numeric_limits<float>::infinity()) continue;
+    v = p.second;
+    _size++;
+  }
+
+  std::vector<std::pair<uint32_t, float>>().swap(_pending);
+}
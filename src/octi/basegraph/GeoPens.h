@@ -0,0 +1,66 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_GEOPENS_H_
+#define OCTI_BASEGRAPH_GEOPENS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace octi {
+namespace basegraph {
+
+// Geo course penalties of a single comb edge, keyed by grid edge id. Only the
+// grid edges in a band around the original geometry carry a penalty. Grid
+// edge ids are assigned in grid order, so the ids in such a band are
+// clustered: the penalties are stored in dense tiles of consecutive ids, and
+// only the tiles which hold at least one penalty are materialized.
+//
+// Penalties are first collected with add(), build() then freezes them into
+// the tiled layout. Lookups are only valid after build(). A built GeoPens
+// is immutable and may be read concurrently.
+class GeoPens {
+ public:
+  GeoPens() {}
+
+  void add(uint32_t id, float pen);
+  void build();
+
+  // the penalty for grid edge id, or def if there is none
+  float get(uint32_t id, float def) const {
+    uint32_t t = id >> TILE_BITS;
+    auto it = std::lower_bound(_tiles.begin(), _tiles.end(), t);
+    if (it == _tiles.end() || *it != t) return def;
+
+    float pen = _vals[((it - _tiles.begin()) << TILE_BITS) | (id & TILE_MASK)];
+    if (pen == std::numeric_limits<float>::infinity()) return def;
+    return pen;
+  }
+
+  size_t size() const { return _size; }
+  size_t numTiles() const { return _tiles.size(); }
+
+ private:
+  static const uint32_t TILE_BITS = 6;
+  static const uint32_t TILE_MASK = (1 << TILE_BITS) - 1;
+
+  std::vector<std::pair<uint32_t, float>> _pending;
+
+  // sorted ids of the materialized tiles
+  std::vector<uint32_t> _tiles;
+
+  // penalty values, TILE_MASK + 1 per materialized tile, infinity for
+  // grid edges without a penalty
+  std::vector<float> _vals;
+
+  size_t _size = 0;
+};
+
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_GEOPENS_H_
@@ -2,8 +2,10 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <cassert>
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/basegraph/GridEdgePL.h"
+#include "octi/basegraph/GridOverlay.h"
 #include "util/String.h"
 #include "util/geo/PolyLine.h"
 
@@ -11,92 +13,117 @@ using util::geo::PolyLine;
 using namespace octi::basegraph;
 
 // _____________________________________________________________________________
-GridEdgePL::GridEdgePL(double c, bool secondary, bool sink)
-    : _c(c),
-      _isSecondary(secondary),
-      _isSink(sink),
-      _closed(false),
-      _softClosed(false),
-      _blocked(false),
-      _resEdgs(0) {}
+GridEdgePL::GridEdgePL(double c, bool secondary, bool sink) {
+  _s.c = c;
+  _s.closed = false;
+  _s.softClosed = false;
+  _s.blocked = false;
+  _s.isSecondary = secondary;
+  _s.isSink = sink;
+  _s.resEdgs = 0;
+}
+
+// _____________________________________________________________________________
+GridEdgeState& GridEdgePL::state() {
+  auto ov = GridOverlay::active();
+  if (!ov) return _s;
+  assert(_id < ov->edgs.size());
+  return ov->edgs[_id];
+}
+
+// _____________________________________________________________________________
+const GridEdgeState& GridEdgePL::state() const {
+  auto ov = GridOverlay::active();
+  if (!ov) return _s;
+  assert(_id < ov->edgs.size());
+  return ov->edgs[_id];
+}
 
 // _____________________________________________________________________________
 const util::geo::Line<double>* GridEdgePL::getGeom() const { return 0; }
 
 // _____________________________________________________________________________
-size_t GridEdgePL::resEdgs() const { return _resEdgs; }
+size_t GridEdgePL::resEdgs() const { return state().resEdgs; }
 
 // _____________________________________________________________________________
 void GridEdgePL::reset() {
-  _closed = false;
-  _resEdgs = 0;
+  auto& s = state();
+  s.closed = false;
+  s.resEdgs = 0;
 }
 
 // _____________________________________________________________________________
 util::json::Dict GridEdgePL::getAttrs() const {
+  const auto& s = state();
   util::json::Dict obj;
   obj["cost"] = cost() == std::numeric_limits<double>::infinity()
                     ? "inf"
                     : util::toString(cost());
-  obj["res_edges"] = util::toString((int)_resEdgs);
-  obj["secondary"] = util::toString((int)_isSecondary);
-  obj["sink"] = util::toString((int)_isSink);
-  obj["closed"] = util::toString(_closed);
-  obj["blocked"] = util::toString(_blocked);
-  obj["softclosed"] = util::toString(_softClosed);
+  obj["res_edges"] = util::toString((int)s.resEdgs);
+  obj["secondary"] = util::toString((int)_s.isSecondary);
+  obj["sink"] = util::toString((int)_s.isSink);
+  obj["closed"] = util::toString(s.closed);
+  obj["blocked"] = util::toString(s.blocked);
+  obj["softclosed"] = util::toString(s.softClosed);
   return obj;
 }
 // _____________________________________________________________________________
 double GridEdgePL::cost() const {
+  const auto& s = state();
+
   // testing relaxed constraints for diagonal intersections
-  if (_softClosed || _blocked) return SOFT_INF + rawCost();
-  if (_closed) return INF;
+  if (s.softClosed || s.blocked) return SOFT_INF + s.c;
+  if (s.closed) return INF;
 
-  return rawCost();
+  return s.c;
 }
 
 // _____________________________________________________________________________
-double GridEdgePL::rawCost() const { return _c; }
+double GridEdgePL::rawCost() const { return state().c; }
 
 // _____________________________________________________________________________
-void GridEdgePL::addResEdge() { _resEdgs++; }
+void GridEdgePL::addResEdge() { state().resEdgs++; }
 
 // _____________________________________________________________________________
 void GridEdgePL::close() {
-  _closed = true;
-  _softClosed = false;
+  auto& s = state();
+  s.closed = true;
+  s.softClosed = false;
 }
 
 // _____________________________________________________________________________
 void GridEdgePL::softClose() {
-  if (!_closed) _softClosed = true;
-  _closed = true;
+  auto& s = state();
+  if (!s.closed) s.softClosed = true;
+  s.closed = true;
 }
 
 // _____________________________________________________________________________
-bool GridEdgePL::closed() const { return _closed; }
+bool GridEdgePL::closed() const { return state().closed; }
 
 // _____________________________________________________________________________
 void GridEdgePL::open() {
-  _closed = false;
-  _softClosed = false;
+  auto& s = state();
+  s.closed = false;
+  s.softClosed = false;
 }
 
 // _____________________________________________________________________________
-void GridEdgePL::block() { _blocked = true; }
+void GridEdgePL::block() { state().blocked = true; }
 
 // _____________________________________________________________________________
-void GridEdgePL::unblock() { _blocked = false; }
+void GridEdgePL::unblock() { state().blocked = false; }
 
 // _____________________________________________________________________________
-void GridEdgePL::setCost(double c) { _c = c; }
+void GridEdgePL::setCost(double c) { state().c = c; }
 
 // _____________________________________________________________________________
-bool GridEdgePL::isSecondary() const { return _isSecondary; }
+bool GridEdgePL::isSecondary() const { return _s.isSecondary; }
 
 // _____________________________________________________________________________
 void GridEdgePL::delResEdg() {
-  if (_resEdgs > 0) _resEdgs--;
+  auto& s = state();
+  if (s.resEdgs > 0) s.resEdgs--;
 }
 
 // _____________________________________________________________________________
@@ -16,6 +16,23 @@ using util::geo::PolyLine;
 namespace octi {
 namespace basegraph {
 
+// routing state of a grid edge, see GridOverlay
+struct GridEdgeState {
+  float c;
+
+  bool closed : 1;
+  bool softClosed : 1;
+
+  // edges are blocked if they would cross a settled edge
+  bool blocked : 1;
+
+  // never change, only kept here as the bits are free
+  bool isSecondary : 1;
+  bool isSink : 1;
+
+  uint8_t resEdgs : 8;
+};
+
 class GridEdgePL : util::geograph::GeoEdgePL<double> {
  public:
   GridEdgePL(double c, bool secondar, bool sink);
@@ -47,20 +64,16 @@ class GridEdgePL : util::geograph::GeoEdgePL<double> {
   size_t getId() const;
 
  private:
-  float _c;
-
-  bool _isSecondary : 1;
-  bool _isSink : 1;
-
-  bool _closed : 1;
-  bool _softClosed : 1;
+  // the state of the graph itself, used if no overlay is active
+  GridEdgeState _s;
 
-  // edges are blocked if they would cross a settled edge
-  bool _blocked : 1;
+  uint32_t _id;
 
-  uint8_t _resEdgs : 8;
+  // the state in the active overlay, if any, otherwise _s
+  GridEdgeState& state();
+  const GridEdgeState& state() const;
 
-  uint32_t _id;
+  friend class GridGraph;
 };
 }
 }
@@ -3,6 +3,7 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -17,6 +18,7 @@
 
 using namespace octi::basegraph;
 using octi::basegraph::GridGraph;
+using octi::basegraph::GridLandmarks;
 using octi::basegraph::NodeCost;
 using util::geo::BezierCurve;
 using util::geo::contains;
@@ -117,9 +119,11 @@ GridNode* GridGraph::neigh(const GridNode* n, size_t i) const {
 
 // _____________________________________________________________________________
 void GridGraph::unSettleNd(CombNode* a) {
-  openTurns(_settled[a]);
-  _settled[a]->pl().setSettled(false);
-  _settled.erase(a);
+  auto& settled = res().settled;
+  auto n = settled[a->pl().getId()];
+  openTurns(n);
+  n->pl().setSettled(false);
+  settled[a->pl().getId()] = 0;
 }
 
 // _____________________________________________________________________________
@@ -133,13 +137,10 @@ void GridGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   assert(ge);
   assert(gf);
 
-  ge->pl().delResEdg();
-  gf->pl().delResEdg();
-
-  _resEdgs[ge].erase(ce);
-  _resEdgs[gf].erase(ce);
+  delResEdg(ge, ce);
+  delResEdg(gf, ce);
 
-  if (_resEdgs[ge].size() == 0) {
+  if (ge->pl().resEdgs() == 0) {
     if (!a->pl().isSettled() && unused(a)) openTurns(a);
     if (!b->pl().isSettled() && unused(b)) openTurns(b);
   }
@@ -150,39 +151,196 @@ CrossEdgPairs GridGraph::getCrossEdgPairs() const { return {}; }
 
 // _____________________________________________________________________________
 void GridGraph::addObstacle(const util::geo::Polygon<double>& obst) {
-  _obstacles.push_back(obst);
   writeObstacleCost(obst);
 }
 
 // _____________________________________________________________________________
-void GridGraph::writeObstacleCost(const util::geo::Polygon<double>& obst) {
-  for (size_t x = 0; x < _grid.getXWidth(); x++) {
-    for (size_t y = 0; y < _grid.getYHeight(); y++) {
-      auto grNdA = getNode(x, y);
+const GridLandmarks* GridGraph::getLandmarks() const {
+  return _landmarks.get();
+}
 
-      for (size_t i = 0; i < maxDeg(); i++) {
-        auto grNeigh = neigh(x, y, i);
-        if (!grNeigh) continue;
-        auto ge = getNEdg(grNdA, grNeigh);
-
-        if (!ge) continue;
-
-        if (intersects(LineSegment<double>(*ge->getFrom()->pl().getGeom(),
-                                           *ge->getTo()->pl().getGeom()),
-                       obst) ||
-            contains(LineSegment<double>(*ge->getFrom()->pl().getGeom(),
-                                         *ge->getTo()->pl().getGeom()),
-                     obst)) {
-          ge->pl().setCost(std::numeric_limits<double>::infinity());
+// _____________________________________________________________________________
+void GridGraph::setLandmarks(std::shared_ptr<const GridLandmarks> lms) {
+  _landmarks = lms;
+}
+
+// _____________________________________________________________________________
+void GridGraph::initOverlay(GridOverlay* ov) const {
+  ov->edgs.assign(_edgeCount, GridEdgeState());
+  ov->nds.assign(_nds.size(), GridNodeState());
+
+  for (auto n : getNds()) {
+    ov->nds[n->pl().getId()] = n->pl()._s;
+    for (auto e : n->getAdjListOut()) ov->edgs[e->pl().getId()] = e->pl()._s;
+  }
+
+  ov->res = _res;
+}
+
+// _____________________________________________________________________________
+GridResidents& GridGraph::res() {
+  auto ov = GridOverlay::active();
+  return ov ? ov->res : _res;
+}
+
+// _____________________________________________________________________________
+const GridResidents& GridGraph::res() const {
+  auto ov = GridOverlay::active();
+  return ov ? ov->res : _res;
+}
+
+// _____________________________________________________________________________
+void GridGraph::blockObstEdg(std::pair<size_t, size_t> id) {
+  assert(_nds.size() > id.first);
+  assert(_nds.size() > id.second);
+  auto ge = getEdg(_nds[id.first], _nds[id.second]);
+  if (!ge) return;
+  ge->pl().setCost(std::numeric_limits<double>::infinity());
+  _obstEdgs.push_back(id);
+}
+
+// _____________________________________________________________________________
+double GridGraph::maxNeighEdgLen() {
+  if (_maxNeighEdgLen >= 0) return _maxNeighEdgLen;
+
+  _maxNeighEdgLen = 0;
+  for (auto grNdA : getNds()) {
+    if (!grNdA->pl().isSink()) continue;
+    for (size_t i = 0; i < maxDeg(); i++) {
+      auto grNeigh = neigh(grNdA, i);
+      if (!grNeigh) continue;
+      _maxNeighEdgLen = std::max(
+          _maxNeighEdgLen,
+          dist(*grNdA->pl().getGeom(), *grNeigh->pl().getGeom()));
+    }
+  }
+
+  return _maxNeighEdgLen;
+}
+
+// _____________________________________________________________________________
+void GridGraph::writeObstacleCost(const util::geo::Polygon<double>& obst) {
+  const auto& outer = obst.getOuter();
+  if (outer.size() < 3) return;
+
+  // rasterize the obstacle onto cells of the grid's cell size, anchored at
+  // the padded bounding box of the obstacle. Cells touched by the outline
+  // are marked as boundary cells, the remaining cells are classified as
+  // inside or outside by a scanline over the cell centers.
+  const uint8_t OUT = 0, IN = 1, BOUND = 2;
+
+  double cs = getCellSize();
+  DBox box = util::geo::pad(util::geo::extendBox(outer, DBox()), cs);
+
+  double x0 = box.getLowerLeft().getX();
+  double y0 = box.getLowerLeft().getY();
+  int64_t w = ceil((box.getUpperRight().getX() - x0) / cs) + 1;
+  int64_t h = ceil((box.getUpperRight().getY() - y0) / cs) + 1;
+
+  std::vector<uint8_t> raster(w * h, OUT);
+
+  // if mark, marks all cells overlapping the bounding box of segment a, b as
+  // boundary cells, otherwise returns true if one of them is a boundary cell
+  auto bndCells = [&](const DPoint& a, const DPoint& b, bool mark) {
+    int64_t xa = floor((std::min(a.getX(), b.getX()) - x0) / cs);
+    int64_t xb = floor((std::max(a.getX(), b.getX()) - x0) / cs);
+    int64_t ya = floor((std::min(a.getY(), b.getY()) - y0) / cs);
+    int64_t yb = floor((std::max(a.getY(), b.getY()) - y0) / cs);
+    for (int64_t x = std::max<int64_t>(xa, 0); x <= std::min(xb, w - 1); x++) {
+      for (int64_t y = std::max<int64_t>(ya, 0); y <= std::min(yb, h - 1);
+           y++) {
+        if (mark) {
+          raster[y * w + x] = BOUND;
+        } else if (raster[y * w + x] == BOUND) {
+          return true;
         }
       }
     }
+    return false;
+  };
+
+  for (size_t i = 0; i < outer.size(); i++) {
+    const auto& a = outer[i];
+    const auto& b = outer[(i + 1) % outer.size()];
+
+    // walk long segments in steps of half a cell, so that only the cells
+    // near the segment are marked, not its whole bounding box
+    size_t steps = std::max(1.0, ceil(dist(a, b) / (cs / 2)));
+    DPoint prev = a;
+    for (size_t j = 1; j <= steps; j++) {
+      double t = static_cast<double>(j) / steps;
+      DPoint cur(a.getX() + t * (b.getX() - a.getX()),
+                 a.getY() + t * (b.getY() - a.getY()));
+      bndCells(prev, cur, true);
+      prev = cur;
+    }
+  }
+
+  std::vector<double> xs;
+  for (int64_t y = 0; y < h; y++) {
+    double yc = y0 + (y + 0.5) * cs;
+    xs.clear();
+    for (size_t i = 0; i < outer.size(); i++) {
+      const auto& a = outer[i];
+      const auto& b = outer[(i + 1) % outer.size()];
+      if ((a.getY() <= yc) == (b.getY() <= yc)) continue;
+      double t = (yc - a.getY()) / (b.getY() - a.getY());
+      xs.push_back(a.getX() + t * (b.getX() - a.getX()));
+    }
+    std::sort(xs.begin(), xs.end());
+
+    for (size_t i = 0; i + 1 < xs.size(); i += 2) {
+      int64_t xa = ceil((xs[i] - x0) / cs - 0.5);
+      int64_t xb = floor((xs[i + 1] - x0) / cs - 0.5);
+      for (int64_t x = std::max<int64_t>(xa, 0); x <= std::min(xb, w - 1);
+           x++) {
+        if (raster[y * w + x] == OUT) raster[y * w + x] = IN;
+      }
+    }
+  }
+
+  // only grid nodes at most one edge length away from the obstacle may have
+  // blocked adjacent edges. On graphs with long edges (Hanan grids, quad
+  // trees) this falls back to a scan of (almost) all nodes.
+  std::set<GridNode*> neighs;
+  _grid.get(util::geo::pad(box, maxNeighEdgLen()), &neighs);
+
+  for (auto grNdA : neighs) {
+    for (size_t i = 0; i < maxDeg(); i++) {
+      auto grNeigh = neigh(grNdA, i);
+      if (!grNeigh) continue;
+      auto ge = getNEdg(grNdA, grNeigh);
+
+      if (!ge) continue;
+
+      const auto& a = *ge->getFrom()->pl().getGeom();
+      const auto& b = *ge->getTo()->pl().getGeom();
+
+      bool blocked = false;
+
+      if (bndCells(a, b, false)) {
+        // the outline passes near the edge, do the exact test
+        LineSegment<double> seg(a, b);
+        blocked = intersects(seg, obst) || contains(seg, obst);
+      } else {
+        // the edge does not cross the outline, it is either completely
+        // inside or completely outside
+        int64_t x = floor((a.getX() - x0) / cs);
+        int64_t y = floor((a.getY() - y0) / cs);
+        blocked = x >= 0 && x < w && y >= 0 && y < h &&
+                  raster[y * w + x] == IN;
+      }
+
+      if (blocked) {
+        blockObstEdg({ge->getFrom()->pl().getId(), ge->getTo()->pl().getId()});
+      }
+    }
   }
 }
 
 // _____________________________________________________________________________
-void GridGraph::writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
-                                   double pen) {
+void GridGraph::writeGeoCoursePens(const CombEdge* ce, GeoPens* target,
+                                   double pen) const {
   std::set<GridNode*> neighs;
 
   DBox box;
@@ -196,7 +354,11 @@ void GridGraph::writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
     geoms.push_back(util::geo::simplify(*orE->pl().getGeom(), 5));
   }
 
-  box = util::geo::pad(box, sqrt(SOFT_INF / pen) * getCellSize());
+  // grid edges farther away than this (in cells) would get a penalty above
+  // SOFT_INF, which is the default for edges without an entry
+  double maxD = sqrt(SOFT_INF / pen);
+
+  box = util::geo::pad(box, maxD * getCellSize());
   _grid.get(box, &neighs);
 
   for (auto grNdA : neighs) {
@@ -208,8 +370,13 @@ void GridGraph::writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
       float d = std::numeric_limits<float>::infinity();
 
       for (const auto& geom : geoms) {
+        double dFr = dist(geom, *ge->getFrom()->pl().getGeom()) / getCellSize();
+
+        // outside of the band, no need to check the remaining points
+        if (dFr > maxD || dFr >= d) continue;
+
         double dLoc = fmax(
-            fmax(dist(geom, *ge->getFrom()->pl().getGeom()) / getCellSize(),
+            fmax(dFr,
                  dist(geom, util::geo::centroid(util::geo::MultiPoint<double>{
                                 *ge->getFrom()->pl().getGeom(),
                                 *ge->getFrom()->pl().getGeom()})) /
@@ -221,9 +388,47 @@ void GridGraph::writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
 
       d *= pen * d;
 
-      if (d <= SOFT_INF) (*target)[ce][ge->pl().getId()] = d;
+      if (d <= SOFT_INF) target->add(ge->pl().getId(), d);
     }
   }
+
+  target->build();
+}
+
+// _____________________________________________________________________________
+void GridGraph::writeCorridorPens(const std::vector<util::geo::DLine>& geoms,
+                                  GeoPens* target, double width) const {
+  std::set<GridNode*> neighs;
+
+  DBox box;
+  for (const auto& geom : geoms) box = util::geo::extendBox(geom, box);
+
+  box = util::geo::pad(box, width * getCellSize());
+  _grid.get(box, &neighs);
+
+  for (auto grNdA : neighs) {
+    for (size_t i = 0; i < maxDeg(); i++) {
+      auto grNeigh = neigh(grNdA->pl().getX(), grNdA->pl().getY(), i);
+      if (!grNeigh) continue;
+      auto ge = getNEdg(grNdA, grNeigh);
+
+      for (const auto& geom : geoms) {
+        if (dist(geom, *ge->getFrom()->pl().getGeom()) / getCellSize() >
+            width) {
+          continue;
+        }
+        if (dist(geom, *ge->getTo()->pl().getGeom()) / getCellSize() >
+            width) {
+          continue;
+        }
+
+        target->add(ge->pl().getId(), 0);
+        break;
+      }
+    }
+  }
+
+  target->build();
 }
 
 // _____________________________________________________________________________
@@ -253,47 +458,79 @@ bool GridGraph::unused(const GridNode* gnd) const {
     if (!neighbor) continue;
     auto e = getNEdg(gnd, neighbor);
     auto f = getNEdg(neighbor, gnd);
-    auto a = _resEdgs.find(const_cast<GridEdge*>(e));
-
-    if (a != _resEdgs.end()) {
-      assert(a->second.size() == e->pl().resEdgs());
-    }
-    if (a != _resEdgs.end() && a->second.size() != 0) return false;
-    a = _resEdgs.find(const_cast<GridEdge*>(f));
-    if (a != _resEdgs.end()) assert(a->second.size() == f->pl().resEdgs());
-    if (a != _resEdgs.end() && a->second.size() != 0) return false;
+    if (e && e->pl().resEdgs()) return false;
+    if (f && f->pl().resEdgs()) return false;
   }
   return true;
 }
 
 // _____________________________________________________________________________
 void GridGraph::addResEdg(GridEdge* ge, CombEdge* ce) {
+  auto& r = res();
+  size_t id = ge->pl().getId();
+  if (id >= r.resEdgs.size()) {
+    r.resEdgs.resize(std::max(id + 1, _edgeCount), 0);
+  }
+
+  if (ge->pl().resEdgs() == 0) {
+    r.resEdgs[id] = ce;
+  } else {
+    r.moreResEdgs[id].push_back(ce);
+  }
+
   ge->pl().addResEdge();
-  _resEdgs[ge].insert(ce);
-  assert(_resEdgs[ge].size() == ge->pl().resEdgs());
+}
+
+// _____________________________________________________________________________
+void GridGraph::delResEdg(GridEdge* ge, CombEdge* ce) {
+  if (ge->pl().resEdgs() == 0) return;
+  ge->pl().delResEdg();
+
+  auto& r = res();
+  size_t id = ge->pl().getId();
+  auto more = r.moreResEdgs.find(id);
+
+  if (more == r.moreResEdgs.end()) {
+    if (r.resEdgs[id] == ce) r.resEdgs[id] = 0;
+    return;
+  }
+
+  auto& v = more->second;
+  if (r.resEdgs[id] == ce) {
+    r.resEdgs[id] = v.back();
+    v.pop_back();
+  } else {
+    auto it = std::find(v.begin(), v.end(), ce);
+    if (it != v.end()) v.erase(it);
+  }
+
+  if (v.empty()) r.moreResEdgs.erase(more);
 }
 
 // _____________________________________________________________________________
 std::set<CombEdge*> GridGraph::getResEdgs(const GridEdge* ge) const {
-  if (!ge) return {};
-  if (_resEdgs.count(const_cast<GridEdge*>(ge)))
-    return _resEdgs.find(const_cast<GridEdge*>(ge))->second;
-  return {};
+  std::set<CombEdge*> ret;
+  if (!ge || ge->pl().resEdgs() == 0) return ret;
+
+  const auto& r = res();
+  size_t id = ge->pl().getId();
+  if (r.resEdgs[id]) ret.insert(r.resEdgs[id]);
+
+  auto more = r.moreResEdgs.find(id);
+  if (more != r.moreResEdgs.end()) {
+    ret.insert(more->second.begin(), more->second.end());
+  }
+
+  return ret;
 }
 
 // _____________________________________________________________________________
 std::set<CombEdge*> GridGraph::getResEdgsDirInd(const GridEdge* ge) const {
-  std::set<CombEdge*> ret;
   if (!ge) return {};
+  std::set<CombEdge*> ret = getResEdgs(ge);
   auto otherEdge = getEdg(ge->getTo(), ge->getFrom());
-  if (_resEdgs.count(const_cast<GridEdge*>(ge))) {
-    const auto& tmp = _resEdgs.find(const_cast<GridEdge*>(ge))->second;
-    ret.insert(tmp.begin(), tmp.end());
-  }
-  if (otherEdge && _resEdgs.count(const_cast<GridEdge*>(otherEdge))) {
-    const auto& tmp = _resEdgs.find(const_cast<GridEdge*>(otherEdge))->second;
-    ret.insert(tmp.begin(), tmp.end());
-  }
+  auto other = getResEdgs(otherEdge);
+  ret.insert(other.begin(), other.end());
   return ret;
 }
 
@@ -551,6 +788,28 @@ std::priority_queue<Candidate> GridGraph::getGridNdCands(const DPoint& p,
   return ret;
 }
 
+// _____________________________________________________________________________
+std::vector<GridNode*> GridGraph::getGridNdsInRad(const DPoint& p,
+                                                  double maxD) const {
+  std::set<GridNode*> neigh;
+
+  DBox b(DPoint(p.getX() - maxD, p.getY() - maxD),
+         DPoint(p.getX() + maxD, p.getY() + maxD));
+
+  _grid.get(b, &neigh);
+
+  std::vector<GridNode*> ret;
+  for (auto n : neigh) {
+    if (dist(*n->pl().getGeom(), p) < maxD) ret.push_back(n);
+  }
+
+  std::sort(ret.begin(), ret.end(), [](const GridNode* a, const GridNode* b) {
+    return a->pl().getId() < b->pl().getId();
+  });
+
+  return ret;
+}
+
 // _____________________________________________________________________________
 const Grid<GridNode*, Point, double>& GridGraph::getGrid() const {
   return _grid;
@@ -669,8 +928,9 @@ void GridGraph::closeSinkFr(GridNode* n) {
 
 // _____________________________________________________________________________
 GridNode* GridGraph::getSettled(const CombNode* cnd) const {
-  auto i = _settled.find(cnd);
-  if (i != _settled.end()) return i->second;
+  size_t id = cnd->pl().getId();
+  const auto& settled = res().settled;
+  if (id < settled.size()) return settled[id];
   return 0;
 }
 
@@ -695,7 +955,7 @@ std::set<GridNode*> GridGraph::getGrNdCands(CombNode* n, size_t maxDis) {
       cands.pop();
     }
   } else {
-    tos.insert(_settled.find(n)->second);
+    tos.insert(getSettled(n));
   }
 
   return tos;
@@ -703,14 +963,15 @@ std::set<GridNode*> GridGraph::getGrNdCands(CombNode* n, size_t maxDis) {
 
 // _____________________________________________________________________________
 void GridGraph::settleNd(GridNode* n, CombNode* cn) {
-  _settled[cn] = n;
+  size_t id = cn->pl().getId();
+  auto& settled = res().settled;
+  if (id >= settled.size()) settled.resize(id + 1, 0);
+  settled[id] = n;
   n->pl().setSettled(true);
 }
 
 // _____________________________________________________________________________
-bool GridGraph::isSettled(const CombNode* cn) {
-  return _settled.find(cn) != _settled.end();
-}
+bool GridGraph::isSettled(const CombNode* cn) { return getSettled(cn) != 0; }
 
 // _____________________________________________________________________________
 GridNode* GridGraph::getGrNdById(size_t id) const { return _nds[id]; }
@@ -817,8 +1078,10 @@ double GridGraph::ndMovePen(const CombNode* cbNd, const GridNode* grNd) const {
 
 // _____________________________________________________________________________
 void GridGraph::reset() {
-  _settled.clear();
-  _resEdgs.clear();
+  auto& r = res();
+  std::fill(r.settled.begin(), r.settled.end(), nullptr);
+  std::fill(r.resEdgs.begin(), r.resEdgs.end(), nullptr);
+  r.moreResEdgs.clear();
   for (auto n : getNds()) {
     for (auto e : n->getAdjListOut()) e->pl().reset();
     if (!n->pl().isSink()) continue;
@@ -833,7 +1096,11 @@ void GridGraph::reset() {
 
 // _____________________________________________________________________________
 void GridGraph::reWriteObstCosts() {
-  for (const auto& obst : _obstacles) writeObstacleCost(obst);
+  for (const auto& id : _obstEdgs) {
+    getEdg(_nds[id.first], _nds[id.second])
+        ->pl()
+        .setCost(std::numeric_limits<double>::infinity());
+  }
 }
 
 // _____________________________________________________________________________
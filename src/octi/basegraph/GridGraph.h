@@ -8,9 +8,11 @@
 #include <queue>
 #include <set>
 #include <unordered_map>
+#include <vector>
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/basegraph/GridEdgePL.h"
 #include "octi/basegraph/GridNodePL.h"
+#include "octi/basegraph/GridOverlay.h"
 #include "octi/basegraph/NodeCost.h"
 #include "octi/combgraph/CombGraph.h"
 #include "util/geo/Geo.h"
@@ -45,6 +47,8 @@ class GridGraph : public BaseGraph {
 
   virtual std::priority_queue<Candidate> getGridNdCands(
       const util::geo::DPoint& p, size_t maxGrD) const;
+  virtual std::vector<GridNode*> getGridNdsInRad(const util::geo::DPoint& p,
+                                                 double maxD) const;
 
   virtual void addCostVec(GridNode* n, const NodeCost& addC);
 
@@ -87,11 +91,18 @@ class GridGraph : public BaseGraph {
 
   virtual CrossEdgPairs getCrossEdgPairs() const;
 
-  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
-                                  double pen);
+  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPens* target,
+                                  double pen) const;
+  virtual void writeCorridorPens(const std::vector<util::geo::DLine>& geoms,
+                                 GeoPens* target, double width) const;
 
   virtual void addObstacle(const util::geo::Polygon<double>& obst);
 
+  virtual const GridLandmarks* getLandmarks() const;
+  virtual void setLandmarks(std::shared_ptr<const GridLandmarks> lms);
+
+  virtual void initOverlay(GridOverlay* ov) const;
+
   virtual const util::graph::Dijkstra::HeurFunc<GridNodePL, GridEdgePL, float>*
   getHeur(const std::set<GridNode*>& to) const;
 
@@ -106,7 +117,6 @@ class GridGraph : public BaseGraph {
 
   Grid<GridNode*, Point, double> _grid;
   double _cellSize, _spacer;
-  std::unordered_map<const CombNode*, GridNode*> _settled;
 
   double _heurHopCost;
 
@@ -116,15 +126,30 @@ class GridGraph : public BaseGraph {
   // edge id counter
   size_t _edgeCount;
 
-  std::vector<util::geo::Polygon<double>> _obstacles;
+  // grid edges blocked by obstacles, re-blocked on reset()
+  ObstEdgs _obstEdgs;
+
+  // length of the longest edge between neighboring grid nodes, -1 if not yet
+  // computed
+  double _maxNeighEdgLen = -1;
+
+  std::shared_ptr<const GridLandmarks> _landmarks;
+
+  // the residents of the graph itself, used if no overlay is active
+  GridResidents _res;
+
+  // the residents of the active overlay, if any, otherwise _res
+  GridResidents& res();
+  const GridResidents& res() const;
 
-  // may be multiple resident edges if hard constraints are relaxed
-  std::unordered_map<GridEdge*, std::set<CombEdge*>> _resEdgs;
+  void delResEdg(GridEdge* ge, CombEdge* ce);
 
   const Grid<GridNode*, Point, double>& getGrid() const;
 
   virtual void writeInitialCosts();
   virtual void writeObstacleCost(const util::geo::Polygon<double>& obst);
+  void blockObstEdg(std::pair<size_t, size_t> id);
+  double maxNeighEdgLen();
   virtual void reWriteObstCosts();
 
   virtual double getBendPen(size_t origI, size_t targetI) const;
@@ -2,14 +2,35 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <cassert>
 #include "octi/basegraph/GridNodePL.h"
+#include "octi/basegraph/GridOverlay.h"
 
 using util::geo::Point;
 using namespace octi::basegraph;
 
 // _____________________________________________________________________________
 GridNodePL::GridNodePL(Point<double> pos)
-    : _pos(pos), _parent(0), _closed(false), _sink(false), _settled(false) {}
+    : _pos(pos), _parent(0), _sink(false) {
+  _s.closed = false;
+  _s.settled = false;
+}
+
+// _____________________________________________________________________________
+GridNodeState& GridNodePL::state() {
+  auto ov = GridOverlay::active();
+  if (!ov) return _s;
+  assert(_id < ov->nds.size());
+  return ov->nds[_id];
+}
+
+// _____________________________________________________________________________
+const GridNodeState& GridNodePL::state() const {
+  auto ov = GridOverlay::active();
+  if (!ov) return _s;
+  assert(_id < ov->nds.size());
+  return ov->nds[_id];
+}
 
 // _____________________________________________________________________________
 const Point<double>* GridNodePL::getGeom() const { return &_pos; }
@@ -18,8 +39,8 @@ const Point<double>* GridNodePL::getGeom() const { return &_pos; }
 util::json::Dict GridNodePL::getAttrs() const {
   util::json::Dict obj;
 
-  obj["settled"] = _settled ? "1" : "0";
-  obj["closed"] = _closed ? "1" : "0";
+  obj["settled"] = state().settled ? "1" : "0";
+  obj["closed"] = state().closed ? "1" : "0";
   obj["grid"] = util::toString(_id);
   obj["x"] = util::toString(_x);
   obj["y"] = util::toString(_y);
@@ -58,16 +79,16 @@ size_t GridNodePL::getX() const { return _parent->pl()._x; }
 size_t GridNodePL::getY() const { return _parent->pl()._y; }
 
 // _____________________________________________________________________________
-void GridNodePL::setClosed(bool c) { _closed = c; }
+void GridNodePL::setClosed(bool c) { state().closed = c; }
 
 // _____________________________________________________________________________
-bool GridNodePL::isClosed() const { return _closed; }
+bool GridNodePL::isClosed() const { return state().closed; }
 
 // _____________________________________________________________________________
-void GridNodePL::setSettled(bool c) { _settled = c; }
+void GridNodePL::setSettled(bool c) { state().settled = c; }
 
 // _____________________________________________________________________________
-bool GridNodePL::isSettled() const { return _settled; }
+bool GridNodePL::isSettled() const { return state().settled; }
 
 // _____________________________________________________________________________
 void GridNodePL::setSink() { _sink = true; }
@@ -16,6 +16,12 @@ using util::graph::Node;
 namespace octi {
 namespace basegraph {
 
+// routing state of a grid node, see GridOverlay
+struct GridNodeState {
+  bool closed : 1;
+  bool settled : 1;
+};
+
 class GridNodePL;
 typedef util::graph::Node<GridNodePL, GridEdgePL> GridNode;
 typedef util::graph::Edge<GridNodePL, GridEdgePL> GridEdge;
@@ -58,9 +64,16 @@ class GridNodePL : util::geograph::GeoNodePL<double> {
 
   uint32_t _x, _y;
   uint32_t _id;
-  bool _closed : 1;
+
+  // the state of the graph itself, used if no overlay is active
+  GridNodeState _s;
   bool _sink : 1;
-  bool _settled : 1;
+
+  // the state in the active overlay, if any, otherwise _s
+  GridNodeState& state();
+  const GridNodeState& state() const;
+
+  friend class GridGraph;
 };
 }  // namespace basegraph
 }  // namespace octi
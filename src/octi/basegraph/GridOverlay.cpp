@@ -0,0 +1,24 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include "octi/basegraph/GridOverlay.h"
+
+using octi::basegraph::GridOverlay;
+
+// _____________________________________________________________________________
+static GridOverlay*& activeOverlay() {
+  static thread_local GridOverlay* ov = 0;
+  return ov;
+}
+
+// _____________________________________________________________________________
+GridOverlay::Scope::Scope(GridOverlay* ov) : _prev(activeOverlay()) {
+  activeOverlay() = ov;
+}
+
+// _____________________________________________________________________________
+GridOverlay::Scope::~Scope() { activeOverlay() = _prev; }
+
+// _____________________________________________________________________________
+GridOverlay* GridOverlay::active() { return activeOverlay(); }
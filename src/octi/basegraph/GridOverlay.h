@@ -0,0 +1,70 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_GRIDOVERLAY_H_
+#define OCTI_BASEGRAPH_GRIDOVERLAY_H_
+
+#include <unordered_map>
+#include <vector>
+#include "octi/basegraph/GridEdgePL.h"
+#include "octi/basegraph/GridNodePL.h"
+#include "octi/combgraph/CombGraph.h"
+
+namespace octi {
+namespace basegraph {
+
+// the grid nodes comb nodes are settled on, and the comb edges resident on
+// grid edges
+struct GridResidents {
+  // settled grid node of each comb node, indexed by comb node id
+  std::vector<GridNode*> settled;
+
+  // first resident comb edge of each grid edge, indexed by grid edge id. The
+  // number of residents is kept in the edge state, there may be multiple
+  // resident edges if hard constraints are relaxed, further ones are kept in
+  // moreResEdgs
+  std::vector<combgraph::CombEdge*> resEdgs;
+  std::unordered_map<size_t, std::vector<combgraph::CombEdge*>> moreResEdgs;
+};
+
+// Routing state of a base graph: the costs and flags of all grid edges and
+// nodes, and the residents. The heuristic workers share one base graph and
+// each of them routes on its own overlay.
+//
+// While an overlay is active on a thread, all state accesses through the
+// grid edge and node payloads and the residents of the graph go to the
+// overlay instead of the graph. Overlays are indexed by grid edge and node
+// id, so an active overlay must only be used with the graph it was
+// initialized from. Topology, geometry and obstacles stay shared and must
+// not be changed while overlays are in use.
+class GridOverlay {
+ public:
+  // activates ov on the calling thread for the lifetime of the scope. Threads
+  // spawned inside the scope do not inherit it.
+  class Scope {
+   public:
+    explicit Scope(GridOverlay* ov);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    GridOverlay* _prev;
+  };
+
+  // the overlay active on the calling thread, 0 if none
+  static GridOverlay* active();
+
+  // state of each grid edge and grid node, indexed by id
+  std::vector<GridEdgeState> edgs;
+  std::vector<GridNodeState> nds;
+
+  GridResidents res;
+};
+
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_GRIDOVERLAY_H_
@@ -0,0 +1,329 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include "octi/basegraph/GridRouter.h"
+
+using octi::basegraph::BaseGraph;
+using octi::basegraph::GridCostFunc;
+using octi::basegraph::GridHeurFunc;
+using octi::basegraph::GridLandmarks;
+using octi::basegraph::GridRouter;
+using octi::basegraph::RadixHeap;
+
+// _____________________________________________________________________________
+void RadixHeap::push(float key, float g, GridNode* n) {
+  if (!(key > 0)) key = 0;
+
+  uint32_t bits;
+  std::memcpy(&bits, &key, sizeof(bits));
+
+  // the heuristic may be slightly inconsistent, never go below the last
+  // extracted key
+  if (bits < _last) bits = _last;
+
+  _buckets[bucket(bits, _last)].push_back({bits, g, n});
+  _size++;
+}
+
+// _____________________________________________________________________________
+RadixHeap::Item RadixHeap::pop() {
+  assert(_size > 0);
+
+  if (_buckets[0].empty()) {
+    size_t i = 1;
+    while (_buckets[i].empty()) i++;
+
+    // the new minimum, all items of bucket i are redistributed into smaller
+    // buckets relative to it
+    uint32_t newLast = _buckets[i].front().key;
+    for (const auto& item : _buckets[i]) newLast = std::min(newLast, item.key);
+
+    for (const auto& item : _buckets[i]) {
+      _buckets[bucket(item.key, newLast)].push_back(item);
+    }
+
+    _buckets[i].clear();
+    _last = newLast;
+  }
+
+  Item ret = _buckets[0].back();
+  _buckets[0].pop_back();
+  _size--;
+  return ret;
+}
+
+// _____________________________________________________________________________
+void RadixHeap::clear() {
+  for (auto& b : _buckets) b.clear();
+  _last = 0;
+  _size = 0;
+}
+
+// _____________________________________________________________________________
+GridLandmarks::GridLandmarks(const BaseGraph* gg, size_t num)
+    : _num(0), _numIds(0), _maxDeg(gg->maxDeg()) {
+  std::vector<const GridNode*> ports;
+  double cx = 0, cy = 0;
+
+  for (auto n : gg->getNds()) {
+    _numIds = std::max(_numIds, n->pl().getId() + 1);
+    if (n->pl().isSink()) continue;
+    ports.push_back(n);
+    cx += n->pl().getGeom()->getX();
+    cy += n->pl().getGeom()->getY();
+  }
+
+  if (ports.empty()) return;
+
+  cx /= ports.size();
+  cy /= ports.size();
+
+  // the landmarks are the outermost ports in num evenly spread directions
+  // from the grid center, landmarks at the border give the best bounds
+  std::vector<const GridNode*> lms;
+  for (size_t i = 0; i < num; i++) {
+    double ang = 2 * M_PI * i / num;
+    const GridNode* best = 0;
+    double bestD = 0;
+    for (auto n : ports) {
+      double d = (n->pl().getGeom()->getX() - cx) * cos(ang) +
+                 (n->pl().getGeom()->getY() - cy) * sin(ang);
+      if (!best || d > bestD ||
+          (d == bestD && n->pl().getId() < best->pl().getId())) {
+        best = n;
+        bestD = d;
+      }
+    }
+    if (std::find(lms.begin(), lms.end(), best) == lms.end()) {
+      lms.push_back(best);
+    }
+  }
+
+  _num = lms.size();
+  _from.resize(_num * _numIds);
+  _to.resize(_num * _numIds);
+
+#pragma omp parallel for
+  for (size_t i = 0; i < 2 * _num; i++) {
+    size_t l = i / 2;
+    if (i % 2 == 0) {
+      dijkstra(lms[l], false, &_from[l * _numIds]);
+    } else {
+      dijkstra(lms[l], true, &_to[l * _numIds]);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void GridLandmarks::dijkstra(const GridNode* lm, bool rev, float* dist) const {
+  std::fill(dist, dist + _numIds, std::numeric_limits<float>::infinity());
+
+  typedef std::pair<double, const GridNode*> QEntry;
+  std::priority_queue<QEntry, std::vector<QEntry>, std::greater<QEntry>> pq;
+
+  dist[lm->pl().getId()] = 0;
+  pq.push({0, lm});
+
+  while (!pq.empty()) {
+    auto cur = pq.top();
+    pq.pop();
+
+    if (cur.first > dist[cur.second->pl().getId()]) continue;
+
+    const auto& adj =
+        rev ? cur.second->getAdjListIn() : cur.second->getAdjListOut();
+
+    for (auto e : adj) {
+      auto n = rev ? e->getFrom() : e->getTo();
+
+      // sink edges are only opened for single routes, and may then be
+      // cheaper than now
+      if (n->pl().isSink()) continue;
+
+      double c = e->pl().cost();
+      if (c >= INF) continue;
+
+      double d = cur.first + c;
+      if (d < dist[n->pl().getId()]) {
+        dist[n->pl().getId()] = d;
+        pq.push({d, n});
+      }
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void GridRouter::newGeneration() {
+  _gen++;
+  if (_gen == 0) {
+    // generation counter overflowed, reset all stamps
+    std::fill(_touched.begin(), _touched.end(), 0);
+    std::fill(_done.begin(), _done.end(), 0);
+    std::fill(_target.begin(), _target.end(), 0);
+    std::fill(_cellTouched.begin(), _cellTouched.end(), 0);
+    _gen = 1;
+  }
+  _pq.clear();
+}
+
+// _____________________________________________________________________________
+size_t GridRouter::touch(GridNode* n, const std::set<GridNode*>& to,
+                         const GridHeurFunc& heur) {
+  size_t id = n->pl().getId();
+  GridNode* cell = n->pl().getParent() ? n->pl().getParent() : n;
+  size_t cellId = cell->pl().getId();
+
+  size_t maxId = std::max(id, cellId);
+  if (maxId >= _touched.size()) {
+    size_t size = std::max(maxId + 1, _touched.size() * 2);
+    _touched.resize(size, 0);
+    _done.resize(size, 0);
+    _target.resize(size, 0);
+    _dist.resize(size);
+    _heur.resize(size);
+    _pred.resize(size);
+    _cellTouched.resize(size, 0);
+    _cellHeur.resize(size);
+  }
+
+  if (_touched[id] != _gen) {
+    if (_cellTouched[cellId] != _gen) {
+      _cellTouched[cellId] = _gen;
+      _cellHeur[cellId] = heur(n, to);
+    }
+
+    _touched[id] = _gen;
+    _dist[id] = std::numeric_limits<float>::infinity();
+    _heur[id] = _cellHeur[cellId];
+    if (_lms && !n->pl().isSink() && id < _lms->numIds()) {
+      _heur[id] = std::max(_heur[id], lmBound(id));
+    }
+    _pred[id] = 0;
+  }
+
+  return id;
+}
+
+// _____________________________________________________________________________
+void GridRouter::initLandmarks(const GridLandmarks* lms,
+                               const std::set<GridNode*>& to) {
+  _lms = 0;
+  if (!lms || lms->size() == 0) return;
+
+  const float inf = std::numeric_limits<float>::infinity();
+  _lmToMax.assign(lms->size(), 0);
+  _lmFrMin.assign(lms->size(), inf);
+
+  // the route ends at a port of a target cell (and its sink edge), the
+  // bounds are taken against the least favorable port
+  bool havePorts = false;
+  for (auto t : to) {
+    for (size_t p = 0; p < lms->maxDeg(); p++) {
+      auto port = t->pl().getPort(p);
+      if (!port || port->pl().getId() >= lms->numIds()) continue;
+      havePorts = true;
+      for (size_t l = 0; l < lms->size(); l++) {
+        _lmToMax[l] = std::max(_lmToMax[l], lms->to(l, port->pl().getId()));
+        _lmFrMin[l] = std::min(_lmFrMin[l], lms->from(l, port->pl().getId()));
+      }
+    }
+  }
+
+  if (havePorts) _lms = lms;
+}
+
+// _____________________________________________________________________________
+float GridRouter::lmBound(size_t id) const {
+  float ret = 0;
+
+  // unreachable landmarks give no bound
+  for (size_t l = 0; l < _lms->size(); l++) {
+    float to = _lms->to(l, id);
+    if (!std::isinf(to) && !std::isinf(_lmToMax[l])) {
+      ret = std::max(ret, to - _lmToMax[l]);
+    }
+
+    float fr = _lms->from(l, id);
+    if (!std::isinf(fr) && !std::isinf(_lmFrMin[l])) {
+      ret = std::max(ret, _lmFrMin[l] - fr);
+    }
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+float GridRouter::shortestPath(
+    const std::set<GridNode*>& from, const std::set<GridNode*>& to,
+    const GridCostFunc& cost, const GridHeurFunc& heur,
+    util::graph::EList<GridNodePL, GridEdgePL>* resEdges,
+    util::graph::NList<GridNodePL, GridEdgePL>* resNodes,
+    const GridLandmarks* lms) {
+  newGeneration();
+  initLandmarks(lms, to);
+
+  const float inf = cost.inf();
+
+  for (auto n : to) {
+    size_t id = touch(n, to, heur);
+    _target[id] = _gen;
+  }
+
+  for (auto n : from) {
+    size_t id = touch(n, to, heur);
+    _dist[id] = 0;
+    _pq.push(_heur[id], 0, n);
+  }
+
+  while (!_pq.empty()) {
+    auto cur = _pq.pop();
+    size_t id = cur.n->pl().getId();
+
+    // stale queue entry
+    if (_done[id] == _gen || cur.g > _dist[id]) continue;
+    _done[id] = _gen;
+    _expanded++;
+
+    if (_target[id] == _gen) {
+      // build the path, target first
+      GridNode* n = cur.n;
+      if (resNodes) resNodes->push_back(n);
+      while (_pred[n->pl().getId()]) {
+        GridEdge* e = _pred[n->pl().getId()];
+        if (resEdges) resEdges->push_back(e);
+        n = e->getFrom();
+        if (resNodes) resNodes->push_back(n);
+      }
+      return cur.g;
+    }
+
+    for (auto e : cur.n->getAdjListOut()) {
+      GridNode* toNd = e->getTo();
+      float c = cost(cur.n, e, toNd);
+      if (c >= inf) continue;
+
+      float g = cur.g + c;
+      if (g >= inf) continue;
+
+      size_t toId = touch(toNd, to, heur);
+      if (g >= _dist[toId]) continue;
+
+      // re-open the node if it was already settled, the heuristic is not
+      // guaranteed to be consistent
+      _dist[toId] = g;
+      _pred[toId] = e;
+      _done[toId] = 0;
+      _pq.push(g + _heur[toId], g, toNd);
+    }
+  }
+
+  return inf;
+}
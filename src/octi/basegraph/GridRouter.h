@@ -0,0 +1,142 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_GRIDROUTER_H_
+#define OCTI_BASEGRAPH_GRIDROUTER_H_
+
+#include <set>
+#include <vector>
+#include "octi/basegraph/BaseGraph.h"
+#include "util/graph/Dijkstra.h"
+
+namespace octi {
+namespace basegraph {
+
+typedef util::graph::Dijkstra::CostFunc<GridNodePL, GridEdgePL, float>
+    GridCostFunc;
+typedef util::graph::Dijkstra::HeurFunc<GridNodePL, GridEdgePL, float>
+    GridHeurFunc;
+
+// monotone radix heap over non-negative float keys, using the fact that the
+// IEEE 754 bit patterns of non-negative floats are ordered like the floats
+// themselves
+class RadixHeap {
+ public:
+  struct Item {
+    uint32_t key;
+    float g;
+    GridNode* n;
+  };
+
+  RadixHeap() : _last(0), _size(0) {}
+
+  void push(float key, float g, GridNode* n);
+  Item pop();
+  bool empty() const { return _size == 0; }
+  void clear();
+
+ private:
+  std::vector<Item> _buckets[33];
+  uint32_t _last;
+  size_t _size;
+
+  static size_t bucket(uint32_t key, uint32_t last) {
+    return key == last ? 0 : 32 - __builtin_clz(key ^ last);
+  }
+};
+
+// ALT landmarks of a base graph: the shortest path distances from and to a
+// few landmark nodes at the border of the grid, computed once on the
+// unsettled graph. Sink edges are ignored, they are only opened for single
+// routes. Settling, node costs and penalties only ever raise or close the
+// remaining edges, so by the triangle inequality the landmark distances stay
+// lower bounds on the distance between two ports for the whole lifetime of
+// the graph (and of all graphs with the same layout).
+class GridLandmarks {
+ public:
+  GridLandmarks(const BaseGraph* gg, size_t num);
+
+  size_t size() const { return _num; }
+  size_t numIds() const { return _numIds; }
+  size_t maxDeg() const { return _maxDeg; }
+
+  // the distance from landmark l to the node with the given id, and from
+  // that node to landmark l
+  float from(size_t l, size_t id) const { return _from[l * _numIds + id]; }
+  float to(size_t l, size_t id) const { return _to[l * _numIds + id]; }
+
+ private:
+  size_t _num;
+  size_t _numIds;
+  size_t _maxDeg;
+
+  std::vector<float> _from;
+  std::vector<float> _to;
+
+  void dijkstra(const GridNode* lm, bool rev, float* dist) const;
+};
+
+// A* router for base graphs. Distances, parents, heuristic values and
+// visited flags are kept in dense arrays indexed by grid node id, which are
+// invalidated in O(1) between searches by a generation counter. A router is
+// not thread safe, use one per thread.
+//
+// The heuristics of all base graphs only depend on the grid cell (the parent
+// node) of a node. The router therefore builds a per-route heuristic field
+// over the grid cells lazily: the heuristic is evaluated once per reached
+// cell, all ports of that cell reuse the value. If landmarks are given, the
+// heuristic of a port is raised to the landmark bound.
+class GridRouter {
+ public:
+  GridRouter() : _gen(0), _expanded(0), _lms(0) {}
+
+  // same semantics as util::graph::Dijkstra::shortestPath: the search stops
+  // at the first settled node in to, edges and nodes are written target first
+  float shortestPath(const std::set<GridNode*>& from,
+                     const std::set<GridNode*>& to, const GridCostFunc& cost,
+                     const GridHeurFunc& heur,
+                     util::graph::EList<GridNodePL, GridEdgePL>* resEdges,
+                     util::graph::NList<GridNodePL, GridEdgePL>* resNodes,
+                     const GridLandmarks* lms = 0);
+
+  // number of nodes expanded by all searches of this router so far
+  size_t expanded() const { return _expanded; }
+
+ private:
+  uint32_t _gen;
+  size_t _expanded;
+
+  // generation in which the entry was last written
+  std::vector<uint32_t> _touched;
+  std::vector<uint32_t> _done;
+  std::vector<uint32_t> _target;
+
+  std::vector<float> _dist;
+  std::vector<float> _heur;
+  std::vector<GridEdge*> _pred;
+
+  // heuristic field over the grid cells, indexed by parent node id
+  std::vector<uint32_t> _cellTouched;
+  std::vector<float> _cellHeur;
+
+  RadixHeap _pq;
+
+  // landmarks of the current route, and per landmark the largest distance
+  // from a target port to it and the smallest distance from it to a target
+  // port
+  const GridLandmarks* _lms;
+  std::vector<float> _lmToMax;
+  std::vector<float> _lmFrMin;
+
+  size_t touch(GridNode* n, const std::set<GridNode*>& to,
+               const GridHeurFunc& heur);
+  void initLandmarks(const GridLandmarks* lms, const std::set<GridNode*>& to);
+  float lmBound(size_t id) const;
+  void newGeneration();
+};
+
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_GRIDROUTER_H_
@@ -43,20 +43,17 @@ void OctiGridGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   assert(ge);
   assert(gf);
 
-  ge->pl().delResEdg();
-  gf->pl().delResEdg();
+  delResEdg(ge, ce);
+  delResEdg(gf, ce);
 
-  _resEdgs[ge].erase(ce);
-  _resEdgs[gf].erase(ce);
-
-  if (_resEdgs[ge].size() == 0) {
+  if (ge->pl().resEdgs() == 0) {
     if (!a->pl().isSettled()) openTurns(a);
     if (!b->pl().isSettled()) openTurns(b);
   }
 
   // unblock blocked diagonal edges crossing this edge
   size_t dir = getDir(a, b);
-  if (dir % 2 != 0 && _resEdgs[ge].size() == 0) {
+  if (dir % 2 != 0 && ge->pl().resEdgs() == 0) {
     size_t x = a->pl().getX();
     size_t y = a->pl().getY();
 
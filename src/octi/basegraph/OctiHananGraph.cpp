@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <unordered_map>
 #include <unordered_set>
 #include "octi/basegraph/NodeCost.h"
@@ -38,24 +39,20 @@ void OctiHananGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   assert(ge);
   assert(gf);
 
-  ge->pl().delResEdg();
-  gf->pl().delResEdg();
+  delResEdg(ge, ce);
+  delResEdg(gf, ce);
 
-  _resEdgs[ge].erase(ce);
-  _resEdgs[gf].erase(ce);
-
-  if (_resEdgs[ge].size() == 0) {
+  if (ge->pl().resEdgs() == 0) {
     if (!a->pl().isSettled() && unused(a)) openTurns(a);
     if (!b->pl().isSettled() && unused(b)) openTurns(b);
   }
 
   // unblock blocked diagonal edges crossing this edge
-  if (getDir(a, b) % 2 != 0 && _resEdgs[ge].size() == 0) {
-    auto pairs = _edgePairs.find(ge);
-    if (pairs == _edgePairs.end()) return;
-    for (auto p : pairs->second) {
-      p.first->pl().unblock();
-      p.second->pl().unblock();
+  if (getDir(a, b) % 2 != 0 && ge->pl().resEdgs() == 0) {
+    auto pairs = getEdgePairs(ge);
+    for (auto p = pairs.first; p != pairs.second; p++) {
+      p->second.first->pl().unblock();
+      p->second.second->pl().unblock();
     }
   }
 }
@@ -97,11 +94,10 @@ void OctiHananGraph::settleEdg(GridNode* a, GridNode* b, CombEdge* e) {
 
   // block diagonal edges crossing this edge
   if (getDir(a, b) % 2 != 0) {
-    auto pairs = _edgePairs.find(ge);
-    if (pairs == _edgePairs.end()) return;
-    for (auto p : pairs->second) {
-      p.first->pl().block();
-      p.second->pl().block();
+    auto pairs = getEdgePairs(ge);
+    for (auto p = pairs.first; p != pairs.second; p++) {
+      p->second.first->pl().block();
+      p->second.second->pl().block();
     }
   }
 }
@@ -109,7 +105,6 @@ void OctiHananGraph::settleEdg(GridNode* a, GridNode* b, CombEdge* e) {
 // _____________________________________________________________________________
 CrossEdgPairs OctiHananGraph::getCrossEdgPairs() const {
   CrossEdgPairs ret;
-  std::unordered_map<const GridEdge*, std::set<const GridEdge*>> have;
 
   for (const GridNode* n : getNds()) {
     if (!n->pl().isSink()) continue;
@@ -119,12 +114,9 @@ CrossEdgPairs OctiHananGraph::getCrossEdgPairs() const {
 
     if (!eOr) continue;
 
-    auto pairs = _edgePairs.find(eOr);
-    if (pairs == _edgePairs.end()) continue;
-
-
-    for (const auto& p : pairs->second) {
-      ret.push_back({{eOr, fOr}, p});
+    auto pairs = getEdgePairs(eOr);
+    for (auto p = pairs.first; p != pairs.second; p++) {
+      ret.push_back({{eOr, fOr}, p->second});
     }
   }
 
@@ -149,206 +141,168 @@ GridEdge* OctiHananGraph::getNEdg(const GridNode* a, const GridNode* b) const {
 
 // _____________________________________________________________________________
 void OctiHananGraph::init() {
-  std::vector<GridNode*> xSorted;
-  std::vector<GridNode*> ySorted;
+  size_t w = _grid.getXWidth();
+  size_t h = _grid.getYHeight();
 
-  _ndIdx.resize(_grid.getXWidth() * _grid.getYHeight());
+  _ndIdx.resize(w * h);
 
-  std::set<std::pair<size_t, size_t>> coords;
+  // grid cells are encoded as x * h + y, sorting the codes yields the cells
+  // in x-major order
+  std::vector<size_t> coords;
 
   // get coords
   for (auto cNd : _cg.getNds()) {
-    int x = _grid.getCellXFromX(cNd->pl().getGeom()->getX());
-    int y = _grid.getCellYFromY(cNd->pl().getGeom()->getY());
-    coords.insert({x, y});
+    size_t x = _grid.getCellXFromX(cNd->pl().getGeom()->getX());
+    size_t y = _grid.getCellYFromY(cNd->pl().getGeom()->getY());
+    coords.push_back(x * h + y);
   }
 
-  // hanan iterations
-  for (size_t i = 1; i < _iters; i++)
-    coords = getIterCoords(coords);
-
-  // write nodes
-  for (auto coord : coords) {
-    int x = coord.first;
-    int y = coord.second;
+  std::sort(coords.begin(), coords.end());
+  coords.erase(std::unique(coords.begin(), coords.end()), coords.end());
 
-    auto nd = writeNd(x, y);
+  std::vector<size_t> rowCol, diag;
 
-    xSorted.push_back(nd);
-    ySorted.push_back(nd);
+  // hanan iterations
+  for (size_t i = 1; i < _iters; i++) {
+    getHananCells(coords, &rowCol, &diag);
+    coords.clear();
+    std::set_union(rowCol.begin(), rowCol.end(), diag.begin(), diag.end(),
+                   std::back_inserter(coords));
   }
 
-  struct {
-    bool operator()(const GridNode* a, const GridNode* b) {
-      return a->pl().getX() < b->pl().getX();
-    }
-  } sortByX;
-
-  struct {
-    bool operator()(const GridNode* a, const GridNode* b) {
-      return a->pl().getY() < b->pl().getY();
-    }
-  } sortByY;
+  if (coords.size() == 0) return;
 
-  if (xSorted.size() == 0) return;
+  // write nodes, the input coords first, then the new cells on row/column
+  // crossings, then the new cells on diagonal crossings
+  for (auto c : coords) writeNd(c / h, c % h);
 
-  std::vector<std::vector<GridNode*>> yAct(_grid.getYHeight());
-  std::vector<std::vector<GridNode*>> xAct(_grid.getXWidth());
+  getHananCells(coords, &rowCol, &diag);
 
-  std::vector<std::vector<GridNode*>> xyAct(_grid.getXWidth() +
-                                            _grid.getYHeight());
-  std::vector<std::vector<GridNode*>> yxAct(_grid.getXWidth() +
-                                            _grid.getYHeight());
-
-  for (auto nd : xSorted) {
-    yAct[nd->pl().getY()].push_back(nd);
+  for (auto c : rowCol) {
+    if (!getNode(c / h, c % h)) writeNd(c / h, c % h);
   }
 
-  for (auto nd : xSorted) {
-    xAct[nd->pl().getX()].push_back(nd);
+  for (auto c : diag) {
+    if (!getNode(c / h, c % h)) writeNd(c / h, c % h);
   }
 
-  for (auto nd : xSorted) {
-    xyAct[nd->pl().getX() + (_grid.getYHeight() - 1 - nd->pl().getY())]
-        .push_back(nd);
-  }
+  // active lines, in port order: columns, xy-diagonals, rows, yx-diagonals
+  std::vector<bool> act[4] = {std::vector<bool>(w), std::vector<bool>(w + h),
+                              std::vector<bool>(h), std::vector<bool>(w + h)};
 
-  for (auto nd : xSorted) {
-    yxAct[nd->pl().getY() + nd->pl().getX()].push_back(nd);
+  for (auto c : coords) {
+    for (size_t dir = 0; dir < 4; dir++) act[dir][line(dir, c / h, c % h)] = 1;
   }
 
-  for (size_t x = 0; x < _grid.getXWidth(); x++) {
-    if (!xAct[x].size()) continue;
-
-    for (size_t y = 0; y < _grid.getYHeight(); y++) {
-      if (!yAct[y].size()) continue;
-      if (getNode(x, y)) continue;
-      auto newNd = writeNd(x, y);
-      yAct[y].push_back(newNd);
-      xAct[x].push_back(newNd);
+  std::vector<size_t> all;
+  std::set_union(coords.begin(), coords.end(), rowCol.begin(), rowCol.end(),
+                 std::back_inserter(all));
+  std::vector<size_t> tmp;
+  std::set_union(all.begin(), all.end(), diag.begin(), diag.end(),
+                 std::back_inserter(tmp));
+  all.swap(tmp);
+
+  // the nodes on each active line, stored consecutively per line. As the
+  // nodes are visited in x-major order, each line is sorted along its
+  // direction.
+  std::vector<size_t> offs[4];
+  std::vector<GridNode*> lineNds[4];
+
+  for (size_t dir = 0; dir < 4; dir++) {
+    offs[dir].resize(act[dir].size() + 1, 0);
+
+    for (auto c : all) {
+      size_t l = line(dir, c / h, c % h);
+      if (act[dir][l]) offs[dir][l + 1]++;
     }
-  }
-
-  for (size_t x = 0; x < _grid.getXWidth(); x++) {
-    for (size_t y = 0; y < _grid.getYHeight(); y++) {
-      size_t xi = x + (_grid.getYHeight() - 1 - y);
-      size_t yi = y + x;
-      if ((xyAct[xi].size() &&
-           (yxAct[yi].size() || yAct[y].size() || xAct[x].size())) ||
-          (yxAct[yi].size() &&
-           (xyAct[xi].size() || yAct[y].size() || xAct[x].size()))) {
-        bool have = false;
-
-        auto newNd = getNode(x, y);
-
-        if (newNd) {
-          have = true;
-        }
-
-        if (!have) newNd = writeNd(x, y);
 
-        if (xyAct[xi].size()) {
-          xyAct[xi].push_back(newNd);
-        }
-
-        if (yxAct[yi].size()) {
-          yxAct[yi].push_back(newNd);
-        }
-
-        if (have) continue;
-
-        if (yAct[y].size()) {
-          yAct[y].push_back(newNd);
-        }
-
-        if (xAct[x].size()) {
-          xAct[x].push_back(newNd);
-        }
-      }
+    for (size_t l = 0; l < act[dir].size(); l++) {
+      offs[dir][l + 1] += offs[dir][l];
     }
-  }
-
-  for (size_t x = 0; x < _grid.getXWidth(); x++) {
-    std::sort(xAct[x].begin(), xAct[x].end(), sortByY);
-  }
 
-  for (size_t y = 0; y < _grid.getYHeight(); y++) {
-    std::sort(yAct[y].begin(), yAct[y].end(), sortByX);
-  }
+    lineNds[dir].resize(offs[dir].back());
+    std::vector<size_t> pos(offs[dir].begin(), offs[dir].end() - 1);
 
-  for (size_t i = 0; i < _grid.getYHeight() + _grid.getXWidth(); i++) {
-    std::sort(xyAct[i].begin(), xyAct[i].end(), sortByY);
-    std::sort(yxAct[i].begin(), yxAct[i].end(), sortByX);
+    for (auto c : all) {
+      size_t l = line(dir, c / h, c % h);
+      if (act[dir][l]) lineNds[dir][pos[l]++] = getNode(c / h, c % h);
+    }
   }
 
-
   // init the _neighs size
   _neighs.resize(_nds.size() * 8);
 
-  for (size_t y = 0; y < _grid.getYHeight(); y++) {
-    for (size_t i = 1; i < yAct[y].size(); i++) {
-      connectNodes(yAct[y][i - 1], yAct[y][i], 2);
-    }
-  }
-
-  for (size_t x = 0; x < _grid.getXWidth(); x++) {
-    for (size_t i = 1; i < xAct[x].size(); i++) {
-      connectNodes(xAct[x][i - 1], xAct[x][i], 0);
-    }
-  }
-
-  for (size_t xi = 0; xi < _grid.getXWidth() + _grid.getYHeight(); xi++) {
-    for (size_t i = 1; i < xyAct[xi].size(); i++) {
-      connectNodes(xyAct[xi][i - 1], xyAct[xi][i], 1);
-    }
-  }
-
-  for (size_t yi = 0; yi < _grid.getXWidth() + _grid.getYHeight(); yi++) {
-    for (size_t i = 1; i < yxAct[yi].size(); i++) {
-      connectNodes(yxAct[yi][i - 1], yxAct[yi][i], 3);
+  for (size_t dir : {2, 0, 1, 3}) {
+    for (size_t l = 0; l < act[dir].size(); l++) {
+      for (size_t i = offs[dir][l] + 1; i < offs[dir][l + 1]; i++) {
+        connectNodes(lineNds[dir][i - 1], lineNds[dir][i], dir);
+      }
     }
   }
 
   // diagonal intersections
-  for (size_t i = 0; i < _grid.getXWidth() + _grid.getYHeight(); i++) {
-    for (size_t j = 1; j < xyAct[i].size(); j++) {
-      auto ndA = xyAct[i][j - 1];
-      auto ndB = xyAct[i][j];
-      if (ndA == ndB) continue;  // there may be duplicates
+  for (size_t l = 0; l < act[1].size(); l++) {
+    for (size_t j = offs[1][l] + 1; j < offs[1][l + 1]; j++) {
+      auto ndA = lineNds[1][j - 1];
+      auto ndB = lineNds[1][j];
 
       auto ea = getNEdg(ndA, ndB);
       auto eb = getNEdg(ndB, ndA);
 
       size_t yi = ndA->pl().getX() + ndA->pl().getY() + 1;
-      if (yi < yxAct.size() && yxAct[yi].size()) {
-        auto it =
-            std::upper_bound(yxAct[yi].begin(), yxAct[yi].end(), ndA, sortByX);
-
-        if (it != yxAct[yi].end() && it != yxAct[yi].begin()) {
-          // it is the first element with an x greater than ndA, which means
-          // that the preceeding element at it-1 has a different x, so we are
-          // filtering out duplicates here automatically
-          auto oNdA = *(it - 1);
-          auto oNdB = *(it);
-          assert(oNdA != oNdB);
-
-          auto fa = getNEdg(oNdA, oNdB);
-          auto fb = getNEdg(oNdB, oNdA);
-
-          _edgePairs[ea].push_back({fa, fb});
-          _edgePairs[eb].push_back({fa, fb});
-
-          _edgePairs[fa].push_back({ea, eb});
-          _edgePairs[fb].push_back({ea, eb});
-        }
-      }
+      if (yi >= act[3].size() || offs[3][yi] == offs[3][yi + 1]) continue;
+
+      auto beg = lineNds[3].begin() + offs[3][yi];
+      auto end = lineNds[3].begin() + offs[3][yi + 1];
+
+      // the first node on the yx-diagonal with an x greater than ndA
+      auto it = std::upper_bound(
+          beg, end, ndA, [](const GridNode* a, const GridNode* b) {
+            return a->pl().getX() < b->pl().getX();
+          });
+
+      if (it == end || it == beg) continue;
+
+      auto fa = getNEdg(*(it - 1), *it);
+      auto fb = getNEdg(*it, *(it - 1));
+
+      _edgePairs.push_back({ea->pl().getId(), {fa, fb}});
+      _edgePairs.push_back({eb->pl().getId(), {fa, fb}});
+
+      _edgePairs.push_back({fa->pl().getId(), {ea, eb}});
+      _edgePairs.push_back({fb->pl().getId(), {ea, eb}});
     }
   }
 
+  // stable, the pairs of each edge keep their order
+  std::stable_sort(_edgePairs.begin(), _edgePairs.end(),
+                   [](const EdgePairEntry& a, const EdgePairEntry& b) {
+                     return a.first < b.first;
+                   });
+
   prunePorts();
   writeInitialCosts();
 }
 
+// _____________________________________________________________________________
+size_t OctiHananGraph::line(size_t dir, size_t x, size_t y) const {
+  if (dir == 0) return x;
+  if (dir == 1) return x + (_grid.getYHeight() - 1 - y);
+  if (dir == 2) return y;
+  return x + y;
+}
+
+// _____________________________________________________________________________
+std::pair<OctiHananGraph::EdgePairIt, OctiHananGraph::EdgePairIt>
+OctiHananGraph::getEdgePairs(const GridEdge* e) const {
+  return std::equal_range(
+      _edgePairs.begin(), _edgePairs.end(),
+      EdgePairEntry{e->pl().getId(), {0, 0}},
+      [](const EdgePairEntry& a, const EdgePairEntry& b) {
+        return a.first < b.first;
+      });
+}
+
 // _____________________________________________________________________________
 void OctiHananGraph::connectNodes(GridNode* grNdFr, GridNode* grNdTo,
                                   size_t p) {
@@ -508,68 +462,63 @@ double OctiHananGraph::ndMovePen(const CombNode* cbNd,
 }
 
 // _____________________________________________________________________________
-std::set<std::pair<size_t, size_t>> OctiHananGraph::getIterCoords(const std::set<std::pair<size_t, size_t>>& inCoords) const {
-
-  std::set<std::pair<size_t, size_t>> ret;
-
-  std::vector<std::pair<size_t, size_t>> xSorted;
-  std::vector<std::pair<size_t, size_t>> ySorted;
-
-  // write nodes
-  for (auto coord : inCoords) {
-    xSorted.push_back(coord);
-    ySorted.push_back(coord);
-  }
-
-  std::vector<std::vector<std::pair<size_t, size_t>>> yAct(_grid.getYHeight());
-  std::vector<std::vector<std::pair<size_t, size_t>>> xAct(_grid.getXWidth());
-
-  std::vector<std::vector<std::pair<size_t, size_t>>> xyAct(_grid.getXWidth() +
-                                            _grid.getYHeight());
-  std::vector<std::vector<std::pair<size_t, size_t>>> yxAct(_grid.getXWidth() +
-                                            _grid.getYHeight());
-
-  for (auto c : xSorted) {
-    yAct[c.second].push_back(c);
-  }
-
-  for (auto c : xSorted) {
-    xAct[c.first].push_back(c);
+void OctiHananGraph::getHananCells(const std::vector<size_t>& coords,
+                                   std::vector<size_t>* rowCol,
+                                   std::vector<size_t>* diag) const {
+  // cells are encoded as x * h + y, see init()
+  int64_t w = _grid.getXWidth();
+  int64_t h = _grid.getYHeight();
+
+  rowCol->clear();
+  diag->clear();
+
+  std::vector<int64_t> xs, ys, xys, yxs;
+  for (auto c : coords) {
+    int64_t x = c / h;
+    int64_t y = c % h;
+    xs.push_back(x);
+    ys.push_back(y);
+    xys.push_back(x + (h - 1 - y));
+    yxs.push_back(x + y);
   }
 
-  for (auto c : xSorted) {
-    xyAct[c.first + (_grid.getYHeight() - 1 - c.second)]
-        .push_back(c);
+  for (auto v : {&xs, &ys, &xys, &yxs}) {
+    std::sort(v->begin(), v->end());
+    v->erase(std::unique(v->begin(), v->end()), v->end());
   }
 
-  for (auto c : xSorted) {
-    yxAct[c.second + c.first].push_back(c);
+  // all crossings of an active row and an active column, already in x-major
+  // order
+  for (auto x : xs) {
+    for (auto y : ys) rowCol->push_back(x * h + y);
   }
 
-  for (size_t x = 0; x < _grid.getXWidth(); x++) {
-    if (!xAct[x].size()) continue;
-
-    for (size_t y = 0; y < _grid.getYHeight(); y++) {
-      if (!yAct[y].size()) continue;
-      if (ret.count({x, y})) continue;
-      ret.insert({x, y});
-      yAct[y].push_back({x, y});
-      xAct[x].push_back({x, y});
+  // all crossings of an active diagonal with another active line
+  auto add = [&](int64_t x, int64_t y) {
+    if (x >= 0 && x < w && y >= 0 && y < h) diag->push_back(x * h + y);
+  };
+
+  for (auto xy : xys) {
+    // on the xy-diagonal, x - y = k
+    int64_t k = xy - (h - 1);
+    for (auto y : ys) add(y + k, y);
+    for (auto x : xs) add(x, x - k);
+
+    // only the yx-diagonals crossing this xy-diagonal inside the grid
+    int64_t lo = 2 * std::max<int64_t>(0, k) - k;
+    int64_t hi = 2 * std::min<int64_t>(w - 1, h - 1 + k) - k;
+    for (auto yx = std::lower_bound(yxs.begin(), yxs.end(), lo);
+         yx != yxs.end() && *yx <= hi; yx++) {
+      if ((*yx + k) % 2) continue;
+      add((*yx + k) / 2, (*yx - k) / 2);
     }
   }
 
-  for (size_t x = 0; x < _grid.getXWidth(); x++) {
-    for (size_t y = 0; y < _grid.getYHeight(); y++) {
-      size_t xi = x + (_grid.getYHeight() - 1 - y);
-      size_t yi = y + x;
-      if ((xyAct[xi].size() &&
-           (yxAct[yi].size() || yAct[y].size() || xAct[x].size())) ||
-          (yxAct[yi].size() &&
-           (xyAct[xi].size() || yAct[y].size() || xAct[x].size()))) {
-        if (!ret.count({x, y})) ret.insert({x, y});
-      }
-    }
+  for (auto yx : yxs) {
+    for (auto y : ys) add(yx - y, y);
+    for (auto x : xs) add(x, yx - x);
   }
 
-  return ret;
+  std::sort(diag->begin(), diag->end());
+  diag->erase(std::unique(diag->begin(), diag->end()), diag->end());
 }
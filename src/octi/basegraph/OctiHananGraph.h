@@ -5,6 +5,8 @@
 #ifndef OCTI_BASEGRAPH_OCTIHANANGRAPH_H_
 #define OCTI_BASEGRAPH_OCTIHANANGRAPH_H_
 
+#include <utility>
+#include <vector>
 #include "octi/basegraph/OctiGridGraph.h"
 
 namespace octi {
@@ -34,15 +36,29 @@ class OctiHananGraph : public OctiGridGraph {
   virtual size_t ang(size_t i, size_t j) const;
   virtual void connectNodes(GridNode* grNdA, GridNode* grNdB, size_t dir);
   virtual void writeInitialCosts();
-  std::set<std::pair<size_t, size_t>> getIterCoords(
-      const std::set<std::pair<size_t, size_t>>& inCoords) const;
+
+  // the cells of one Hanan iteration over coords (sorted cell codes): the
+  // crossings of active rows and columns, and the crossings of active
+  // diagonals with any other active line. Both are sorted.
+  void getHananCells(const std::vector<size_t>& coords,
+                     std::vector<size_t>* rowCol,
+                     std::vector<size_t>* diag) const;
+
+  // the line through x, y in direction dir (port 0 to 3)
+  size_t line(size_t dir, size_t x, size_t y) const;
 
   const combgraph::CombGraph& _cg;
   size_t _iters;
   std::vector<size_t> _ndIdx;
   std::vector<GridNode*> _neighs;
 
-  std::map<GridEdge*, std::vector<std::pair<GridEdge*, GridEdge*>>> _edgePairs;
+  // diagonal edge pairs crossing a diagonal edge, keyed by the edge id and
+  // sorted by it
+  typedef std::pair<size_t, std::pair<GridEdge*, GridEdge*>> EdgePairEntry;
+  typedef std::vector<EdgePairEntry>::const_iterator EdgePairIt;
+  std::vector<EdgePairEntry> _edgePairs;
+
+  std::pair<EdgePairIt, EdgePairIt> getEdgePairs(const GridEdge* e) const;
 };
 }  // namespace basegraph
 }  // namespace octi
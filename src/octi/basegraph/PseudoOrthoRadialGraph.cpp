@@ -28,37 +28,10 @@ int PseudoOrthoRadialGraph::multi(size_t y) const {
   return 1 << lg;
 }
 
-// _____________________________________________________________________________
-void PseudoOrthoRadialGraph::writeObstacleCost(
-    const util::geo::Polygon<double>& obst) {
-  for (size_t y = 1; y < _grid.getYHeight() / 2; y++) {
-    for (size_t x = 0; x < _numBeams * multi(y); x++) {
-      auto grNdA = getNode(x, y);
-
-      for (size_t i = 0; i < maxDeg(); i++) {
-        auto grNeigh = neigh(x, y, i);
-        if (!grNeigh) continue;
-        auto ge = getNEdg(grNdA, grNeigh);
-
-        if (intersects(
-                util::geo::LineSegment<double>(*ge->getFrom()->pl().getGeom(),
-                                               *ge->getTo()->pl().getGeom()),
-                obst) ||
-            contains(
-                util::geo::LineSegment<double>(*ge->getFrom()->pl().getGeom(),
-                                               *ge->getTo()->pl().getGeom()),
-                obst)) {
-          ge->pl().setCost(std::numeric_limits<double>::infinity());
-        }
-      }
-    }
-  }
-}
-
 // _____________________________________________________________________________
 void PseudoOrthoRadialGraph::writeGeoCoursePens(const CombEdge* ce,
-                                                GeoPensMap* target,
-                                                double pen) {
+                                                GeoPens* target,
+                                                double pen) const {
   std::set<GridNode*> neighs;
 
   DBox box;
@@ -72,7 +45,11 @@ void PseudoOrthoRadialGraph::writeGeoCoursePens(const CombEdge* ce,
     geoms.push_back(util::geo::simplify(*orE->pl().getGeom(), 5));
   }
 
-  box = util::geo::pad(box, sqrt(SOFT_INF / pen) * getCellSize());
+  // grid edges farther away than this (in cells) would get a penalty above
+  // SOFT_INF, which is the default for edges without an entry
+  double maxD = sqrt(SOFT_INF / pen);
+
+  box = util::geo::pad(box, maxD * getCellSize());
   _grid.get(box, &neighs);
 
   for (auto grNdA : neighs) {
@@ -84,8 +61,13 @@ void PseudoOrthoRadialGraph::writeGeoCoursePens(const CombEdge* ce,
       double d = std::numeric_limits<double>::infinity();
 
       for (const auto& geom : geoms) {
+        double dFr = dist(geom, *ge->getFrom()->pl().getGeom()) / getCellSize();
+
+        // outside of the band, no need to check the remaining points
+        if (dFr > maxD || dFr >= d) continue;
+
         double dLoc = fmax(
-            fmax(dist(geom, *ge->getFrom()->pl().getGeom()) / getCellSize(),
+            fmax(dFr,
                  dist(geom, util::geo::centroid(util::geo::MultiPoint<double>{
                                 *ge->getFrom()->pl().getGeom(),
                                 *ge->getFrom()->pl().getGeom()})) /
@@ -97,9 +79,11 @@ void PseudoOrthoRadialGraph::writeGeoCoursePens(const CombEdge* ce,
 
       d *= pen * d;
 
-      if (d <= SOFT_INF) (*target)[ce][ge->pl().getId()] = d;
+      if (d <= SOFT_INF) target->add(ge->pl().getId(), d);
     }
   }
+
+  target->build();
 }
 
 // _____________________________________________________________________________
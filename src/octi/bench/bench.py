@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+# Runs octi with every base graph over a set of input networks and collects
+# the statistics written by --write-stats into a single JSON report.
+#
+# usage: bench.py <octi binary> <example dir> <report file> [octi args...]
+
+import glob
+import json
+import os
+import subprocess
+import sys
+import time
+
+# base graph names as accepted by octi -b. "orthoradial" is an alias of
+# "pseudoorthoradial" on the command line and is therefore not run twice.
+BASE_GRAPHS = [
+    "ortholinear",
+    "octilinear",
+    "chulloctilinear",
+    "pseudoorthoradial",
+    "octihanan",
+    "quadtree",
+    "hexalinear",
+]
+
+
+def stats(out):
+    # the statistics dict is part of the top level GeoJSON object
+    for obj in [out, out.get("properties", {})]:
+        if "statistics" in obj:
+            return obj["statistics"], obj.get("component-statistics", [])
+    return None, []
+
+
+def run(octi, network, base_graph, args):
+    cmd = [octi, "--write-stats", "-b", base_graph] + args
+    ret = {"network": os.path.basename(network)[:-5], "base-graph": base_graph}
+
+    start = time.time()
+    with open(network) as f:
+        proc = subprocess.run(cmd, stdin=f, stdout=subprocess.PIPE,
+                              stderr=subprocess.PIPE)
+    ret["wall-ms"] = (time.time() - start) * 1000
+
+    if proc.returncode != 0:
+        ret["status"] = "error"
+        ret["exit-code"] = proc.returncode
+        ret["stderr"] = proc.stderr.decode(errors="replace")[-2000:]
+        return ret
+
+    try:
+        ret["statistics"], ret["component-statistics"] = stats(
+            json.loads(proc.stdout))
+    except ValueError:
+        ret["statistics"] = None
+
+    ret["status"] = "ok" if ret["statistics"] else "no-statistics"
+    return ret
+
+
+def main():
+    if len(sys.argv) < 4:
+        sys.stderr.write("usage: %s <octi binary> <example dir> <report file> "
+                         "[octi args...]\n" % sys.argv[0])
+        sys.exit(1)
+
+    octi, example_dir, report_file = sys.argv[1:4]
+    args = sys.argv[4:]
+
+    networks = sorted(glob.glob(os.path.join(example_dir, "*.json")))
+
+    runs = []
+    for network in networks:
+        for base_graph in BASE_GRAPHS:
+            sys.stderr.write("%s, %s... " % (os.path.basename(network),
+                                             base_graph))
+            sys.stderr.flush()
+            r = run(octi, network, base_graph, args)
+            sys.stderr.write("%s (%.0f ms)\n" % (r["status"], r["wall-ms"]))
+            runs.append(r)
+
+    report = {
+        "timestamp": int(time.time()),
+        "octi-args": args,
+        "runs": runs,
+    }
+
+    with open(report_file, "w") as f:
+        json.dump(report, f, indent=2)
+
+    sys.stderr.write("Report written to %s\n" % report_file)
+
+    # nodes expanded by the shortest path searches, per base graph
+    for base_graph in BASE_GRAPHS:
+        expanded = [r["statistics"].get("nodes-expanded", 0) for r in runs
+                    if r["base-graph"] == base_graph and r["status"] == "ok"]
+        sys.stderr.write("%s: %d nodes expanded in %d runs\n" %
+                         (base_graph, sum(expanded), len(expanded)))
+
+    if any(r["status"] != "ok" for r in runs):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
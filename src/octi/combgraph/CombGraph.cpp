@@ -32,6 +32,7 @@ void CombGraph::build(const LineGraph* source) {
 
   for (auto n : nodes) {
     CombNode* cn = addNd(n);
+    cn->pl().setId(m.size());
     m[n] = cn;
   }
 
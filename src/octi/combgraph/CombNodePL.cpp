@@ -43,6 +43,12 @@ void CombNodePL::setEdgeOrdering(
   _ordering = ordering;
 }
 
+// _____________________________________________________________________________
+void CombNodePL::setId(size_t id) { _id = id; }
+
+// _____________________________________________________________________________
+size_t CombNodePL::getId() const { return _id; }
+
 // _____________________________________________________________________________
 std::string CombNodePL::toString() const {
   std::stringstream ret;
@@ -56,6 +56,17 @@ Score Drawing::fullScore() const {
 
 // _____________________________________________________________________________
 void Drawing::draw(CombEdge* ce, const GrEdgList& ges, bool rev) {
+  journal(&Drawing::_nds, ce->getFrom());
+  journal(&Drawing::_nds, ce->getTo());
+  journal(&Drawing::_ndReachCosts, ce->getFrom());
+  journal(&Drawing::_ndReachCosts, ce->getTo());
+  journal(&Drawing::_ndBndCosts, ce->getFrom());
+  journal(&Drawing::_ndBndCosts, ce->getTo());
+  journal(&Drawing::_edgs, ce);
+  journal(&Drawing::_edgCosts, ce);
+  journal(&Drawing::_vios, ce);
+  journal(&Drawing::_springCosts, ce);
+
   if (_c == std::numeric_limits<double>::infinity()) _c = 0;
   if (_edgs.count(ce)) _edgs[ce].clear();
 
@@ -466,8 +477,39 @@ void Drawing::getLineGraph(LineGraph* target) const {
     }
   }
 }
+// _____________________________________________________________________________
+void Drawing::checkpoint() {
+  _journal.checkpoints.push_back(
+      std::make_tuple(_journal.entries.size(), _c, _violations));
+}
+
+// _____________________________________________________________________________
+void Drawing::rollback() {
+  assert(!_journal.checkpoints.empty());
+
+  size_t pos;
+  std::tie(pos, _c, _violations) = _journal.checkpoints.back();
+  _journal.checkpoints.pop_back();
+
+  while (_journal.entries.size() > pos) {
+    _journal.entries.back()(this);
+    _journal.entries.pop_back();
+  }
+}
+
+// _____________________________________________________________________________
+void Drawing::commit() {
+  assert(!_journal.checkpoints.empty());
+  _journal.checkpoints.pop_back();
+
+  // an enclosing checkpoint may still roll back these changes
+  if (_journal.checkpoints.empty()) _journal.entries.clear();
+}
+
 // _____________________________________________________________________________
 void Drawing::crumble() {
+  _journal.entries.clear();
+  _journal.checkpoints.clear();
   _c = std::numeric_limits<double>::infinity();
   _violations = 0;
   _nds.clear();
@@ -550,6 +592,13 @@ const std::map<const CombEdge*, GrPath>& Drawing::getEdgPaths() const {
 
 // _____________________________________________________________________________
 void Drawing::erase(CombEdge* ce) {
+  journal(&Drawing::_edgs, ce);
+  journal(&Drawing::_edgCosts, ce);
+  journal(&Drawing::_springCosts, ce);
+  journal(&Drawing::_ndBndCosts, ce->getFrom());
+  journal(&Drawing::_ndBndCosts, ce->getTo());
+  journal(&Drawing::_vios, ce);
+
   _edgs.erase(ce);
   _c -= _edgCosts[ce];
   _edgCosts.erase(ce);
@@ -573,6 +622,10 @@ void Drawing::erase(CombEdge* ce) {
 
 // _____________________________________________________________________________
 void Drawing::erase(CombNode* cn) {
+  journal(&Drawing::_nds, cn);
+  journal(&Drawing::_ndReachCosts, cn);
+  journal(&Drawing::_ndBndCosts, cn);
+
   _nds.erase(cn);
   _c -= _ndReachCosts[cn];
   _c -= _ndBndCosts[cn];
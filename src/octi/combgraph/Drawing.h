@@ -1,7 +1,10 @@
 #ifndef OCTI_COMBGRAPH_DRAWING_H_
 #define OCTI_COMBGRAPH_DRAWING_H_
 
+#include <functional>
 #include <map>
+#include <tuple>
+#include <vector>
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/combgraph/CombGraph.h"
 #include "util/graph/Dijkstra.h"
@@ -22,6 +25,28 @@ using util::graph::Dijkstra;
 typedef Dijkstra::EList<GridNodePL, GridEdgePL> GrEdgList;
 typedef std::vector<std::pair<size_t, size_t>> GrPath;
 
+// wall times of the phases of a schematization in ms, and the number of grid
+// nodes expanded by all shortest path searches
+struct PhaseStats {
+  double gridMs = 0;
+  double geoPensMs = 0;
+  double initMs = 0;
+  double locSearchMs = 0;
+  double ilpMs = 0;
+  size_t ndsExpanded = 0;
+};
+
+inline PhaseStats operator+(const PhaseStats& lh, const PhaseStats& rh) {
+  PhaseStats ret;
+  ret.gridMs = lh.gridMs + rh.gridMs;
+  ret.geoPensMs = lh.geoPensMs + rh.geoPensMs;
+  ret.initMs = lh.initMs + rh.initMs;
+  ret.locSearchMs = lh.locSearchMs + rh.locSearchMs;
+  ret.ilpMs = lh.ilpMs + rh.ilpMs;
+  ret.ndsExpanded = lh.ndsExpanded + rh.ndsExpanded;
+  return ret;
+}
+
 struct Score {
   Score(double bend, double move, double hop, double dense, double full,
         uint64_t violations, size_t iters)
@@ -41,10 +66,13 @@ struct Score {
   double full;
   uint64_t violations;
   size_t iters;
+  PhaseStats phases;
 };
 
 inline Score operator+(const Score& lh, const Score& rh) {
-  return Score(lh.bend + rh.bend, lh.move + rh.move, lh.hop + rh.hop, lh.dense + rh.dense, lh.full + rh.full, lh.violations + rh.violations, lh.iters + rh.iters);
+  Score ret(lh.bend + rh.bend, lh.move + rh.move, lh.hop + rh.hop, lh.dense + rh.dense, lh.full + rh.full, lh.violations + rh.violations, lh.iters + rh.iters);
+  ret.phases = lh.phases + rh.phases;
+  return ret;
 }
 
 struct NodeOnSeg {
@@ -71,6 +99,22 @@ struct Segment {
   std::set<CombEdge*> combEdges;
 };
 
+class Drawing;
+
+// undo journal of a drawing, holds the previous state of every map entry
+// changed since the oldest open checkpoint. Copies of a drawing start with an
+// empty journal.
+struct DrawingJournal {
+  DrawingJournal() {}
+  DrawingJournal(const DrawingJournal&) {}
+  DrawingJournal& operator=(const DrawingJournal&) { return *this; }
+
+  std::vector<std::function<void(Drawing*)>> entries;
+
+  // journal position, cost and number of violations at each checkpoint
+  std::vector<std::tuple<size_t, double, size_t>> checkpoints;
+};
+
 class Drawing {
  public:
   Drawing(const BaseGraph* gg)
@@ -110,6 +154,15 @@ class Drawing {
 
   const std::map<const CombEdge*, GrPath>& getEdgPaths() const;
 
+  // start recording all changes to this drawing, checkpoints may be nested
+  void checkpoint();
+
+  // undo all changes since the last checkpoint and remove it
+  void rollback();
+
+  // keep all changes since the last checkpoint and remove it
+  void commit();
+
  private:
   std::map<const CombNode*, size_t> _nds;
   std::map<const CombEdge*, GrPath> _edgs;
@@ -124,7 +177,23 @@ class Drawing {
 
   size_t _violations;
 
+  DrawingJournal _journal;
+
   double recalcBends(const CombNode* nd);
+
+  template <typename K, typename V, typename KK>
+  void journal(std::map<K, V> Drawing::*m, const KK& key) {
+    if (_journal.checkpoints.empty()) return;
+    K k = key;
+    auto it = (this->*m).find(k);
+    if (it == (this->*m).end()) {
+      _journal.entries.push_back([m, k](Drawing* d) { (d->*m).erase(k); });
+    } else {
+      V old = it->second;
+      _journal.entries.push_back(
+          [m, k, old](Drawing* d) { (d->*m)[k] = old; });
+    }
+  }
 };
 }  // namespace combgraph
 }  // namespace octi
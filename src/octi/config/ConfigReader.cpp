@@ -6,6 +6,7 @@
 #include <float.h>
 #include <getopt.h>
 
+#include <algorithm>
 #include <exception>
 #include <iostream>
 #include <string>
@@ -47,6 +48,12 @@ void ConfigReader::help(const char* bin) const {
             << "optimization mode, 'heur' or 'ilp'\n"
             << std::setw(39) << "  --obstacles arg"
             << "GeoJSON file containing obstacle polygons\n"
+            << std::setw(39) << "  --from-prev arg"
+            << "previous octi output, unchanged parts of the\n"
+            << std::setw(39) << " "
+            << " network are kept in place, only changed edges\n"
+            << std::setw(39) << " "
+            << " are rerouted (heur only)\n"
             << std::setw(39) << "  -g [ --grid-size ] arg (=100%)"
             << "grid cell length, either exact or a\n"
             << std::setw(39) << " "
@@ -58,6 +65,10 @@ void ConfigReader::help(const char* bin) const {
             << "Misc:\n"
             << std::setw(39) << "  --retry-on-error"
             << "retry 85\% of grid size on error, 30 times\n"
+            << std::setw(39) << "  --retry-par arg (=1)"
+            << "with --retry-on-error, number of grid sizes\n"
+            << std::setw(39) << " "
+            << " tried in parallel, largest success is kept\n"
             << std::setw(39) << "  --skip-on-error"
             << "skip graph on error\n"
             << std::setw(39) << "  --ilp-num-threads arg (=0)"
@@ -68,16 +79,60 @@ void ConfigReader::help(const char* bin) const {
             << "number of Hanan grid iterations\n"
             << std::setw(39) << "  --loc-search-max-iters arg (=100)"
             << "max local search iterations\n"
+            << std::setw(39) << "  --heur-jobs arg (=4)"
+            << "number of parallel workers for heur, each\n"
+            << std::setw(39) << " "
+            << " with its own overlay of the grid graph,\n"
+            << std::setw(39) << " "
+            << " 0 means all cores\n"
+            << std::setw(39) << "  --landmarks arg (=4)"
+            << "number of ALT landmarks per grid graph used\n"
+            << std::setw(39) << " "
+            << " to guide heur routing, 0 disables them\n"
+            << std::setw(39) << "  --comp-jobs arg (=1)"
+            << "number of components drawn in parallel for\n"
+            << std::setw(39) << " "
+            << " heur, 0 means all cores\n"
+            << std::setw(39) << "  --multi-level arg (=1)"
+            << "number of grid levels for heur, each coarser\n"
+            << std::setw(39) << " "
+            << " level doubles the grid size, finer levels route\n"
+            << std::setw(39) << " "
+            << " in a corridor around the coarser solution\n"
             << std::setw(39) << "  --ilp-cache-threshold arg (=inf)"
             << "ILP solve cache treshold\n"
             << std::setw(39) << "  --ilp-time-limit arg (=60)"
             << "ILP solve time limit (seconds), -1 for infinite\n"
+            << std::setw(39) << "  --ilp-rel-gap arg (=0)"
+            << "stop ILP solve at this relative gap,\n"
+            << std::setw(39) << " "
+            << " 0 means solver default\n"
+            << std::setw(39) << "  --ilp-corridor arg (=0)"
+            << "restrict ILP to this many grid cells around\n"
+            << std::setw(39) << " "
+            << " the heuristic solution, widened if no solution\n"
+            << std::setw(39) << " "
+            << " is found, 0 means full grid\n"
+            << std::setw(39) << "  --ilp-window arg (=0)"
+            << "solve the ILP in overlapping windows of this\n"
+            << std::setw(39) << " "
+            << " many grid cells over the heuristic solution,\n"
+            << std::setw(39) << " "
+            << " 0 means a single ILP\n"
             << std::setw(39) << "  --ilp-cache-dir arg (=.)"
             << "ILP cache dir\n"
             << std::setw(39) << "  --ilp-solver arg (=gurobi)"
             << "Preferred ILP solver, either glpk, cbc, or gurobi,\n"
             << std::setw(39) << " "
             << " will fall back if not available.\n"
+            << std::setw(39) << "  --ilp-profile arg (=octi)"
+            << "ILP solver parameter profile, one of generic,\n"
+            << std::setw(39) << " "
+            << " loom, octi\n"
+            << std::setw(39) << "  --ilp-profile-bench"
+            << "Optimize with each ILP solver profile and\n"
+            << std::setw(39) << " "
+            << " output a comparison as JSON instead of the graph\n"
             << std::setw(39) << "  --write-stats"
             << "write stats to output graph\n"
             << std::setw(39) << "  -D [ --from-dot ]"
@@ -90,6 +145,10 @@ void ConfigReader::help(const char* bin) const {
             << "max grid distance for station candidates\n"
             << std::setw(39) << "  --restr-loc-search"
             << "restrict local search to max grid distance\n"
+            << std::setw(39) << "  --loc-search-multi-move"
+            << "commit all non-overlapping improving moves\n"
+            << std::setw(39) << " "
+            << " per local search iteration\n"
             << std::setw(39) << "  --edge-order arg (=all)"
             << "method used for initial edge ordering for heur,\n"
             << std::setw(39) << " "
@@ -154,6 +213,18 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
                          {"skip-on-error", no_argument, 0, 25},
                          {"retry-on-error", no_argument, 0, 26},
                          {"abort-after", required_argument, 0, 'a'},
+                         {"ilp-profile", required_argument, 0, 27},
+                         {"ilp-rel-gap", required_argument, 0, 28},
+                         {"heur-jobs", required_argument, 0, 29},
+                         {"comp-jobs", required_argument, 0, 30},
+                         {"retry-par", required_argument, 0, 31},
+                         {"ilp-corridor", required_argument, 0, 32},
+                         {"loc-search-multi-move", no_argument, 0, 33},
+                         {"multi-level", required_argument, 0, 34},
+                         {"from-prev", required_argument, 0, 35},
+                         {"ilp-window", required_argument, 0, 36},
+                         {"ilp-profile-bench", no_argument, 0, 37},
+                         {"landmarks", required_argument, 0, 38},
                          {0, 0, 0, 0}};
 
   int c;
@@ -247,6 +318,42 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 26:
         cfg->retryOnError = true;
         break;
+      case 27:
+        cfg->ilpProfile = optarg;
+        break;
+      case 28:
+        cfg->ilpRelGap = atof(optarg);
+        break;
+      case 29:
+        cfg->heurJobs = std::max(0, atoi(optarg));
+        break;
+      case 30:
+        cfg->compJobs = std::max(0, atoi(optarg));
+        break;
+      case 31:
+        cfg->retryPar = atoi(optarg);
+        break;
+      case 32:
+        cfg->ilpCorridor = atof(optarg);
+        break;
+      case 33:
+        cfg->locSearchMultiMove = true;
+        break;
+      case 34:
+        cfg->multiLevels = std::max(1, atoi(optarg));
+        break;
+      case 35:
+        cfg->prevPath = optarg;
+        break;
+      case 36:
+        cfg->ilpWindow = atof(optarg);
+        break;
+      case 37:
+        cfg->ilpProfileBench = true;
+        break;
+      case 38:
+        cfg->landmarks = atoi(optarg);
+        break;
       case 'g':
         cfg->gridSize = optarg;
         break;
@@ -33,20 +33,31 @@ struct Config {
   bool fromDot = false;
   bool deg2Heur = true;
   bool restrLocSearch = false;
+  bool locSearchMultiMove = false;
   double enfGeoPen = 0;
   bool ilpNoSolve = false;
   int ilpTimeLimit = 60;
   int ilpNumThreads = 0;
+  double ilpRelGap = 0;
+  double ilpCorridor = 0;
+  double ilpWindow = 0;
   double ilpCacheThreshold = DBL_MAX;
   std::string ilpSolver = "gurobi";
+  std::string ilpProfile = "octi";
+  bool ilpProfileBench = false;
   std::string ilpCacheDir = ".";
 
   bool skipOnError = false;
   bool retryOnError = false;
+  size_t retryPar = 1;
 
   double maxGrDist = 3;
 
   int heurLocSearchIters = 100;
+  size_t heurJobs = 4;
+  size_t landmarks = 4;
+  size_t compJobs = 1;
+  size_t multiLevels = 1;
 
   size_t abortAfter = -1;
 
@@ -58,6 +69,11 @@ struct Config {
   std::string obstaclePath;
   std::vector<util::geo::DPolygon> obstacles;
 
+  // previous drawing for incremental re-schematization, read from prevPath
+  // and owned by main
+  std::string prevPath;
+  const shared::linegraph::LineGraph* prev = 0;
+
   octi::basegraph::BaseGraphType baseGraphType;
 
   octi::basegraph::Penalties pens;
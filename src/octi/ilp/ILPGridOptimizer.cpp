@@ -2,6 +2,8 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 
 #include "octi/basegraph/BaseGraph.h"
@@ -11,12 +13,16 @@
 #include "util/log/Log.h"
 
 using octi::basegraph::BaseGraph;
+using octi::basegraph::CrossEdgPairs;
 using octi::basegraph::GeoPensMap;
 using octi::basegraph::GridEdge;
 using octi::basegraph::GridNode;
 using octi::combgraph::Drawing;
+using octi::ilp::ColIdx;
+using octi::ilp::CrossIdx;
 using octi::ilp::ILPGridOptimizer;
 using octi::ilp::ILPStats;
+using octi::ilp::Window;
 using shared::optim::ILPSolver;
 using shared::optim::StarterSol;
 
@@ -26,98 +32,288 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
                                     bool noSolve, const GeoPensMap* geoPensMap,
                                     int timeLim, const std::string& cacheDir,
                                     double cacheThreshold, int numThreads,
+                                    double relGap, double corridor,
                                     const std::string& solverStr,
+                                    const std::string& solverProfile,
                                     const std::string& path) const {
-  // extract first feasible solution from gridgraph
   ILPStats s{std::numeric_limits<double>::infinity(), 0, 0, 0, 0};
-  StarterSol sol = extractFeasibleSol(d, gg, cg, maxGrDist);
-  gg->reset();
 
-  for (auto nd : gg->getNds()) {
-    // if we presolve, some edges may be blocked
-    for (auto e : nd->getAdjList()) {
-      e->pl().open();
-      e->pl().unblock();
+  // if requested, restrict the ILP to a corridor around the grid cells used
+  // by the first feasible solution
+  Corridor corr;
+  const Corridor* corrPtr = 0;
+  std::vector<const GridNode*> core;
+
+  if (corridor > 0) {
+    core = getDrawingCells(d, gg, cg);
+    if (core.empty()) {
+      LOGTO(INFO, std::cerr) << "No feasible solution to build a corridor "
+                                "around, using the full grid";
+    } else if (writeCorridor(gg, core, corridor, &corr)) {
+      corrPtr = &corr;
+      LOGTO(DEBUG, std::cerr) << "Restricting ILP to a corridor of "
+                              << corridor << " cells (" << corr.size()
+                              << " grid cells)";
     }
-    if (!nd->pl().isSink()) continue;
-    gg->openTurns(nd);
-    gg->closeSinkFr(nd);
-    gg->closeSinkTo(nd);
   }
 
+  // extract first feasible solution from gridgraph
+  StarterSol sol = extractFeasibleSol(d, gg, cg, maxGrDist, corrPtr, 0);
+
   // clear drawing
   d->crumble();
 
-  auto lp = createProblem(gg, cg, geoPensMap, maxGrDist, solverStr);
+  CrossIdx crossIdx(gg->getCrossEdgPairs());
+
+  while (true) {
+    openGrid(gg);
 
-  s.cols = lp->getNumVars();
-  s.rows = lp->getNumConstrs();
+    ColIdx idx;
+    auto lp = createProblem(gg, cg, geoPensMap, maxGrDist, corrPtr, 0,
+                            crossIdx, solverStr, solverProfile, &idx);
 
-  lp->setStarter(sol);
+    s.cols = lp->getNumVars();
+    s.rows = lp->getNumConstrs();
 
-  if (path.size()) {
-    std::string basename = path;
-    size_t pos = basename.find_last_of(".");
-    if (pos != std::string::npos) basename = basename.substr(0, pos);
+    lp->setStarter(sol);
 
-    std::string outf = basename + ".sol";
-    std::string solutionF = basename + ".mst";
-    lp->writeMst(solutionF, sol);
-    lp->writeMps(path);
+    if (path.size()) {
+      std::string basename = path;
+      size_t pos = basename.find_last_of(".");
+      if (pos != std::string::npos) basename = basename.substr(0, pos);
+
+      std::string outf = basename + ".sol";
+      std::string solutionF = basename + ".mst";
+      lp->writeMst(solutionF, sol);
+      lp->writeMps(path);
+    }
+
+    double time;
+
+    if (!noSolve) {
+      if (timeLim >= 0) lp->setTimeLim(timeLim);
+      if (cacheDir.size()) lp->setCacheDir(cacheDir);
+      lp->setCacheThreshold(cacheThreshold);
+      if (numThreads != 0) lp->setNumThreads(numThreads);
+      if (relGap > 0) lp->setRelGapLim(relGap);
+      lp->setProgressCb(shared::optim::logProgress);
+      T_START(ilp);
+      auto status = lp->solve();
+      time = T_STOP(ilp);
+
+      if (status == shared::optim::SolveType::INF) {
+        delete lp;
+
+        if (corrPtr) {
+          // widen the corridor and try again, fall back to the full grid
+          // once the corridor covers it
+          corridor *= 2;
+          if (!writeCorridor(gg, core, corridor, &corr)) corrPtr = 0;
+          LOGTO(INFO, std::cerr)
+              << "No solution found in corridor, widening to " << corridor
+              << " cells" << (corrPtr ? "" : " (full grid)");
+          continue;
+        }
+
+        throw std::runtime_error(
+            "No solution found for ILP problem (most likely because of a time "
+            "limit)!");
+      }
+
+      extractSolution(lp, gg, cg, idx, 0, d);
+      shared::linegraph::LineGraph tg;
+      d->getLineGraph(&tg);
+
+      s.score = lp->getObjVal();
+      s.time = time;
+      s.optimal = (status == shared::optim::SolveType::OPTIM);
+    }
+
+    delete lp;
+    break;
   }
 
-  double time;
+  return s;
+}
 
-  if (!noSolve) {
-    if (timeLim >= 0) lp->setTimeLim(timeLim);
-    if (cacheDir.size()) lp->setCacheDir(cacheDir);
-    lp->setCacheThreshold(cacheThreshold);
-    if (numThreads != 0) lp->setNumThreads(numThreads);
-    T_START(ilp);
-    auto status = lp->solve();
-    time = T_STOP(ilp);
+// _____________________________________________________________________________
+ILPStats ILPGridOptimizer::optimizeWindowed(
+    BaseGraph* gg, const CombGraph& cg, combgraph::Drawing* d,
+    double maxGrDist, const GeoPensMap* geoPensMap, int timeLim,
+    const std::string& cacheDir, double cacheThreshold, int numThreads,
+    double relGap, double window, size_t jobs, const std::string& solverStr,
+    const std::string& solverProfile) const {
+  ILPStats s{0, 0, 0, 0, false};
+
+  if (jobs == 0) jobs = 1;
+
+  CrossIdx crossIdx(gg->getCrossEdgPairs());
+
+  size_t round = 0;
+  bool improved = true;
+
+  while (improved) {
+    improved = false;
+    round++;
+
+    size_t numWins = 0, numImpr = 0;
+
+    // the windows of a single batch are disjoint, so they can be solved
+    // independently of each other
+    for (size_t batch = 0; batch < 4; batch++) {
+      openGrid(gg);
+
+      auto wins = getWindows(gg, cg, d, window, batch, crossIdx);
+      if (wins.empty()) continue;
+
+      std::vector<ILPSolver*> lps(wins.size());
+      std::vector<ColIdx> idxs(wins.size());
+      std::vector<double> curCosts(wins.size());
+      std::vector<shared::optim::SolveType> status(wins.size());
+
+      for (size_t i = 0; i < wins.size(); i++) {
+        const auto& win = wins[i];
+        curCosts[i] = getCost(gg, d, geoPensMap, win.nds, win.edgs);
+
+        lps[i] = createProblem(gg, cg, geoPensMap, maxGrDist, &win.cells,
+                               &win, crossIdx, solverStr, solverProfile,
+                               &idxs[i]);
+        lps[i]->setStarter(
+            extractFeasibleSol(d, gg, cg, maxGrDist, &win.cells, &win));
+
+        if (timeLim >= 0) lps[i]->setTimeLim(timeLim);
+        if (cacheDir.size()) lps[i]->setCacheDir(cacheDir);
+        lps[i]->setCacheThreshold(cacheThreshold);
+        if (numThreads != 0) lps[i]->setNumThreads(numThreads);
+        if (relGap > 0) lps[i]->setRelGapLim(relGap);
+
+        s.cols = std::max<size_t>(s.cols, lps[i]->getNumVars());
+        s.rows = std::max<size_t>(s.rows, lps[i]->getNumConstrs());
+      }
+
+      T_START(ilp);
+#pragma omp parallel for schedule(dynamic) num_threads(jobs)
+      for (size_t i = 0; i < wins.size(); i++) status[i] = lps[i]->solve();
+      s.time += T_STOP(ilp);
+
+      for (size_t i = 0; i < wins.size(); i++) {
+        const auto& win = wins[i];
+        numWins++;
+
+        // the solver objective is only exact up to its tolerances, only
+        // accept strict improvements
+        if (status[i] != shared::optim::SolveType::INF &&
+            lps[i]->getObjVal() + 1e-3 < curCosts[i]) {
+          for (auto nd : cg.getNds()) {
+            for (auto edg : nd->getAdjList()) {
+              if (edg->getFrom() != nd || !win.edgs.count(edg)) continue;
+              d->erase(edg);
+            }
+          }
 
-    if (status == shared::optim::SolveType::INF) {
-      delete lp;
-      throw std::runtime_error(
-          "No solution found for ILP problem (most likely because of a time "
-          "limit)!");
+          for (auto nd : cg.getNds()) {
+            if (win.nds.count(nd) && !win.fixed.count(nd)) d->erase(nd);
+          }
+
+          extractSolution(lps[i], gg, cg, idxs[i], &win, d);
+
+          numImpr++;
+          improved = true;
+        }
+
+        delete lps[i];
+      }
     }
 
-    extractSolution(lp, gg, cg, d);
-    shared::linegraph::LineGraph tg;
-    d->getLineGraph(&tg);
+    LOGTO(DEBUG, std::cerr) << "ILP window round " << round << ": improved "
+                            << numImpr << " of " << numWins << " windows";
+  }
+
+  // write the final drawing to the grid, and score it like the ILP would
+  openGrid(gg);
 
-    s.score = lp->getObjVal();
-    s.time = time;
-    s.optimal = (status == shared::optim::SolveType::OPTIM);
+  std::set<const CombNode*> nds;
+  std::set<const CombEdge*> edgs;
+
+  for (auto nd : cg.getNds()) {
+    if (nd->getDeg() == 0) continue;
+    nds.insert(nd);
+    for (auto edg : nd->getAdjList()) {
+      if (edg->getFrom() != nd) continue;
+      edgs.insert(edg);
+
+      auto pth = d->getEdgPaths().find(edg);
+      if (pth == d->getEdgPaths().end()) continue;
+      for (auto xy : pth->second) {
+        gg->addResEdg(const_cast<GridEdge*>(gg->getGrEdgById(xy)), edg);
+      }
+    }
   }
 
-  delete lp;
+  s.score = getCost(gg, d, geoPensMap, nds, edgs);
 
   return s;
 }
 
+// _____________________________________________________________________________
+void ILPGridOptimizer::openGrid(BaseGraph* gg) const {
+  gg->reset();
+
+  for (auto nd : gg->getNds()) {
+    // if we presolve, some edges may be blocked
+    for (auto e : nd->getAdjList()) {
+      e->pl().open();
+      e->pl().unblock();
+    }
+    if (!nd->pl().isSink()) continue;
+    gg->openTurns(nd);
+    gg->closeSinkFr(nd);
+    gg->closeSinkTo(nd);
+  }
+}
+
 // _____________________________________________________________________________
 ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
                                            const GeoPensMap* geoPensMap,
                                            double maxGrDist,
-                                           const std::string& solverStr) const {
-  ILPSolver* lp = shared::optim::getSolver(solverStr, shared::optim::MIN);
+                                           const Corridor* corr,
+                                           const Window* win,
+                                           const CrossIdx& crossIdx,
+                                           const std::string& solverStr,
+                                           const std::string& solverProfile,
+                                           ColIdx* idx) const {
+  ILPSolver* lp =
+      shared::optim::getSolver(solverStr, shared::optim::MIN, solverProfile);
 
   // grid nodes that may potentially be a position for an
   // input station
   std::map<const CombNode*, std::set<const GridNode*>> cands;
 
+  // threshold for speedup
+  double maxDis = gg->getCellSize() * maxGrDist;
+
+  // the grid nodes the ILP may use, only the corridor is enumerated
+  auto grNds = getCorridorNds(gg, corr);
+
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
+    if (win && !win->nds.count(nd)) continue;
     std::stringstream oneAssignment;
     // must sum up to 1
     oneAssignment << "oneass(" << nd << ")";
     int rowStat = lp->addRow(oneAssignment.str(), 1, shared::optim::FIX);
 
-    for (const GridNode* n : gg->getNds()) {
+    // nodes fixed by a window only have their current cell as a candidate
+    std::vector<GridNode*> ndCands;
+    if (win && win->fixed.count(nd)) {
+      ndCands.push_back(const_cast<GridNode*>(win->fixed.find(nd)->second));
+    } else {
+      ndCands = gg->getGridNdsInRad(*nd->pl().getGeom(), maxDis);
+    }
+
+    for (GridNode* n : ndCands) {
       if (!n->pl().isSink()) continue;
+      if (!inCorridor(n, corr)) continue;
 
       // don't use nodes as candidates which cannot hold the comb node due to
       // their degree
@@ -125,22 +321,15 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
         continue;
       }
 
-      double gridD = dist(*n->pl().getGeom(), *nd->pl().getGeom());
-
-      // threshold for speedup
-      double maxDis = gg->getCellSize() * maxGrDist;
-      if (gridD >= maxDis) {
-        continue;
-      }
-
       cands[nd].insert(n);
 
-      gg->openSinkFr(const_cast<GridNode*>(n), 0);
-      gg->openSinkTo(const_cast<GridNode*>(n), 0);
+      gg->openSinkFr(n, 0);
+      gg->openSinkTo(n, 0);
 
       auto varName = getStatPosVar(n, nd);
 
       int col = lp->addCol(varName, shared::optim::BIN, gg->ndMovePen(nd, n));
+      idx->statPos[nd][n] = col;
 
       lp->addColToRow(rowStat, col, 1);
     }
@@ -151,9 +340,12 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
   for (auto nd : cg.getNds()) {
     for (auto edg : nd->getAdjList()) {
       if (edg->getFrom() != nd) continue;
-      for (const GridNode* n : gg->getNds()) {
+      if (win && !win->edgs.count(edg)) continue;
+      for (const GridNode* n : grNds) {
         for (const GridEdge* e : n->getAdjList()) {
           if (e->getFrom() != n) continue;
+          if (!inCorridor(e->getTo(), corr)) continue;
+          if (win && win->blocked.count(e)) continue;
           if (e->pl().cost() >= basegraph::SOFT_INF) {
             // skip infinite edges, we cannot use them.
             // this also skips sink edges of nodes not used as
@@ -175,18 +367,16 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
           double coef;
           if (geoPensMap && !e->pl().isSecondary()) {
-            // add geo pen
-            auto thisMap = geoPensMap->find(edg)->second;
-            auto i = thisMap.find(e->pl().getId());
-            if (i != thisMap.end()) coef = e->pl().cost() + i->second;
-
-            // if no geopen was present for grid edge, we assume SOFT_INF
-            // penalty
-            coef = e->pl().cost() + octi::basegraph::SOFT_INF;
+            // add geo pen, if no geopen was present for grid edge, we assume
+            // SOFT_INF penalty
+            const auto& thisPens = geoPensMap->find(edg)->second;
+            coef = e->pl().cost() +
+                   thisPens.get(e->pl().getId(), octi::basegraph::SOFT_INF);
           } else {
             coef = e->pl().cost();
           }
-          lp->addCol(edgeVarName, shared::optim::BIN, coef);
+          idx->edgUse[edg][e] =
+              lp->addCol(edgeVarName, shared::optim::BIN, coef);
         }
       }
     }
@@ -196,7 +386,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
   // an edge can only be used a single time
   std::set<const GridEdge*> proced;
-  for (const GridNode* n : gg->getNds()) {
+  for (const GridNode* n : grNds) {
     for (const GridEdge* e : n->getAdjList()) {
       if (e->pl().isSecondary()) continue;
       if (proced.count(e)) continue;
@@ -214,12 +404,9 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
           if (edg->getFrom() != nd) continue;
           if (e->pl().cost() >= basegraph::SOFT_INF) continue;
 
-          auto eVarName = getEdgUseVar(e, edg);
-          auto fVarName = getEdgUseVar(f, edg);
-
-          int eCol = lp->getVarByName(eVarName);
+          int eCol = idx->getEdgUseCol(e, edg);
           if (eCol > -1) lp->addColToRow(row, eCol, 1);
-          int fCol = lp->getVarByName(fVarName);
+          int fCol = idx->getEdgUseCol(f, edg);
           if (fCol > -1) lp->addColToRow(row, fCol, 1);
         }
       }
@@ -228,12 +415,13 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
   // for every node, the number of outgoing and incoming used edges must be
   // the same, except for the start and end node
-  for (const GridNode* n : gg->getNds()) {
+  for (const GridNode* n : grNds) {
     if (nonInfDeg(n) == 0) continue;
 
     for (auto nd : cg.getNds()) {
       for (auto edg : nd->getAdjList()) {
         if (edg->getFrom() != nd) continue;
+        if (win && !win->edgs.count(edg)) continue;
         std::stringstream constName;
         constName << "as(" << n->pl().getId() << "," << edg << ")";
 
@@ -262,25 +450,25 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
         if (n->pl().isSink()) {
           // subtract the variable for this start node and edge, if used
           // as a candidate
-          int ndColFrom = lp->getVarByName(getStatPosVar(n, edg->getFrom()));
+          int ndColFrom = idx->getStatPosCol(n, edg->getFrom());
           if (ndColFrom > -1) lp->addColToRow(row, ndColFrom, -2);
 
           // add the variable for this end node and edge, if used
           // as a candidate
-          int ndColTo = lp->getVarByName(getStatPosVar(n, edg->getTo()));
+          int ndColTo = idx->getStatPosCol(n, edg->getTo());
           if (ndColTo > -1) lp->addColToRow(row, ndColTo, 1);
 
           outCost = 2;
         }
 
         for (auto e : n->getAdjListIn()) {
-          int edgCol = lp->getVarByName(getEdgUseVar(e, edg));
+          int edgCol = idx->getEdgUseCol(e, edg);
           if (edgCol < 0) continue;
           lp->addColToRow(row, edgCol, inCost);
         }
 
         for (auto e : n->getAdjListOut()) {
-          int edgCol = lp->getVarByName(getEdgUseVar(e, edg));
+          int edgCol = idx->getEdgUseCol(e, edg);
           if (edgCol < 0) continue;
           lp->addColToRow(row, edgCol, outCost);
         }
@@ -294,12 +482,14 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
   // node
   // THIS RULE IS REDUNDANT AND IMPLICITELY ENFORCED BY OTHER RULES,
   // BUT SEEMS TO LEAD TO FASTER SOLUTION TIMES
-  for (GridNode* n : gg->getNds()) {
+  for (GridNode* n : grNds) {
     if (!n->pl().isSink()) continue;
 
     for (auto nd : cg.getNds()) {
       for (auto e : nd->getAdjList()) {
         if (e->getFrom() != nd) continue;
+        // sink edges of fixed edges have no columns
+        if (win && !win->edgs.count(e)) continue;
 
         std::stringstream constName;
         constName << "ss(" << n->pl().getId() << "," << e << ")";
@@ -312,12 +502,12 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
         } else {
           if (cands[e->getTo()].count(n)) {
-            int ndColTo = lp->getVarByName(getStatPosVar(n, e->getTo()));
+            int ndColTo = idx->getStatPosCol(n, e->getTo());
             if (ndColTo > -1) lp->addColToRow(row, ndColTo, -1);
           }
 
           if (cands[e->getFrom()].count(n)) {
-            int ndColFr = lp->getVarByName(getStatPosVar(n, e->getFrom()));
+            int ndColFr = idx->getStatPosCol(n, e->getFrom());
             if (ndColFr > -1) lp->addColToRow(row, ndColFr, -1);
           }
         };
@@ -325,13 +515,10 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
         for (size_t p = 0; p < gg->maxDeg(); p++) {
           auto portNd = n->pl().getPort(p);
           if (!portNd) continue;
-          auto varSinkTo = getEdgUseVar(gg->getEdg(portNd, n), e);
-          auto varSinkFr = getEdgUseVar(gg->getEdg(n, portNd), e);
-
-          int ndColTo = lp->getVarByName(varSinkTo);
+          int ndColTo = idx->getEdgUseCol(gg->getEdg(portNd, n), e);
           if (ndColTo > -1) lp->addColToRow(row, ndColTo, 1);
 
-          int ndColFr = lp->getVarByName(varSinkFr);
+          int ndColFr = idx->getEdgUseCol(gg->getEdg(n, portNd), e);
           if (ndColFr > -1) lp->addColToRow(row, ndColFr, 1);
         }
       }
@@ -340,7 +527,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
   // a grid node can either be an activated sink, or a single pass through
   // edge is used
-  for (GridNode* n : gg->getNds()) {
+  for (GridNode* n : grNds) {
     if (!n->pl().isSink()) continue;
 
     std::stringstream constName;
@@ -352,7 +539,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
     // a pass-through
 
     for (auto nd : cg.getNds()) {
-      int ndcolto = lp->getVarByName(getStatPosVar(n, nd).c_str());
+      int ndcolto = idx->getStatPosCol(n, nd);
       if (ndcolto > -1) lp->addColToRow(row, ndcolto, 1);
     }
 
@@ -369,7 +556,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
           for (auto edg : nd->getAdjList()) {
             if (edg->getFrom() != nd) continue;
 
-            int edgCol = lp->getVarByName(getEdgUseVar(innerE, edg));
+            int edgCol = idx->getEdgUseCol(innerE, edg);
             if (edgCol < 0) continue;
             lp->addColToRow(row, edgCol, 1);
           }
@@ -380,9 +567,20 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
   lp->update();
 
-  // dont allow crossing edges
+  // dont allow crossing edges, only crossings of edges with columns are
+  // relevant
+  std::set<size_t> crossPairs;
+  for (const auto& edgCols : idx->edgUse) {
+    for (const auto& eCol : edgCols.second) {
+      const auto& pairs = crossIdx.getEdgePairs(eCol.first);
+      crossPairs.insert(pairs.begin(), pairs.end());
+    }
+  }
+
   size_t rowId = 0;
-  for (auto edgPair : gg->getCrossEdgPairs()) {
+  for (size_t pairId : crossPairs) {
+    const auto& edgPair = crossIdx.pairs[pairId];
+
     std::stringstream constName;
     constName << "nc(" << rowId << ")";
     rowId++;
@@ -393,16 +591,16 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
       for (auto edg : nd->getAdjList()) {
         if (edg->getFrom() != nd) continue;
 
-        int col = lp->getVarByName(getEdgUseVar(edgPair.first.first, edg));
+        int col = idx->getEdgUseCol(edgPair.first.first, edg);
         if (col > -1) lp->addColToRow(row, col, 1);
 
-        col = lp->getVarByName(getEdgUseVar(edgPair.first.second, edg));
+        col = idx->getEdgUseCol(edgPair.first.second, edg);
         if (col > -1) lp->addColToRow(row, col, 1);
 
-        col = lp->getVarByName(getEdgUseVar(edgPair.second.first, edg));
+        col = idx->getEdgUseCol(edgPair.second.first, edg);
         if (col > -1) lp->addColToRow(row, col, 1);
 
-        col = lp->getVarByName(getEdgUseVar(edgPair.second.second, edg));
+        col = idx->getEdgUseCol(edgPair.second.second, edg);
         if (col > -1) lp->addColToRow(row, col, 1);
       }
     }
@@ -414,11 +612,22 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
   // E at N
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() < 2) continue;  // we don't need this for deg 1 nodes
+    if (win && !win->nds.count(nd)) continue;
     for (auto edg : nd->getAdjList()) {
       std::stringstream dirName;
       dirName << "d(" << nd << "," << edg << ")";
+
+      if (win && !win->edgs.count(edg)) {
+        // edges leaving the window keep their port
+        size_t dir = win->fixedDirs.find({nd, edg})->second;
+        idx->dir[{nd, edg}] =
+            lp->addCol(dirName.str(), shared::optim::INT, 0, dir, dir);
+        continue;
+      }
+
       int col =
           lp->addCol(dirName.str(), shared::optim::INT, 0, 0, gg->maxDeg() - 1);
+      idx->dir[{nd, edg}] = col;
 
       std::stringstream constName;
       constName << "dc(" << nd << "," << edg << ")";
@@ -427,21 +636,15 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
       lp->addColToRow(row, col, -1);
 
-      for (GridNode* n : gg->getNds()) {
-        if (!n->pl().isSink()) continue;
-
-        // check if this grid node is used as a candidate for comb node
-        // if not, we don't have to add the constraints
-        int ndColFrom = lp->getVarByName(getStatPosVar(n, nd));
-        if (ndColFrom == -1) continue;
-
+      // only the candidate cells of the comb node have to be considered
+      for (const GridNode* n : cands[nd]) {
         if (edg->getFrom() == nd) {
           // the 0 can be skipped here
           for (size_t i = 1; i < gg->maxDeg(); i++) {
             auto portNd = n->pl().getPort(i);
             if (!portNd) continue;
             auto e = gg->getEdg(n, portNd);
-            int col = lp->getVarByName(getEdgUseVar(e, edg));
+            int col = idx->getEdgUseCol(e, edg);
             if (col > -1) lp->addColToRow(row, col, i);
           }
         } else {
@@ -450,7 +653,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
             auto portNd = n->pl().getPort(i);
             if (!portNd) continue;
             auto e = gg->getEdg(portNd, n);
-            int col = lp->getVarByName(getEdgUseVar(e, edg));
+            int col = idx->getEdgUseCol(e, edg);
             if (col > -1) lp->addColToRow(row, col, i);
           }
         }
@@ -466,6 +669,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
   for (auto nd : cg.getNds()) {
     // for degree < 3, the circular ordering cannot be violated
     if (nd->getDeg() < 3) continue;
+    if (win && !win->nds.count(nd)) continue;
 
     std::stringstream vulnConstName;
     vulnConstName << "vc(" << nd << ")";
@@ -474,11 +678,12 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
     int vulnRow = lp->addRow(vulnConstName.str(), 1, shared::optim::FIX);
 
+    std::vector<int> vulnCols(nd->getDeg());
     for (size_t i = 0; i < nd->getDeg(); i++) {
       std::stringstream n;
       n << "vuln(" << nd << "," << i << ")";
-      int col = lp->addCol(n.str(), shared::optim::BIN, 0);
-      lp->addColToRow(vulnRow, col, 1);
+      vulnCols[i] = lp->addCol(n.str(), shared::optim::BIN, 0);
+      lp->addColToRow(vulnRow, vulnCols[i], 1);
     }
 
     lp->update();
@@ -496,24 +701,17 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
       assert(edgA != edgB);
 
-      std::stringstream colNameA;
-      colNameA << "d(" << nd << "," << edgA << ")";
-      int colA = lp->getVarByName(colNameA.str());
+      int colA = idx->getDirCol(nd, edgA);
       assert(colA > -1);
 
-      std::stringstream colNameB;
-      colNameB << "d(" << nd << "," << edgB << ")";
-      int colB = lp->getVarByName(colNameB.str());
+      int colB = idx->getDirCol(nd, edgB);
       assert(colB > -1);
 
       std::stringstream constName;
       constName << "oc(" << nd << "," << i << ")";
       int row = lp->addRow(constName.str(), 1, shared::optim::LO);
 
-      std::stringstream vulnColName;
-      vulnColName << "vuln(" << nd << "," << i << ")";
-      int vulnCol = lp->getVarByName(vulnColName.str());
-      assert(vulnCol > -1);
+      int vulnCol = vulnCols[i];
 
       lp->addColToRow(row, colB, 1);
       lp->addColToRow(row, colA, -1);
@@ -528,6 +726,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
   // for each adjacent edge pair, add variables telling the accuteness of the
   // angle between them
   for (auto nd : cg.getNds()) {
+    if (win && !win->nds.count(nd)) continue;
     for (size_t i = 0; i < nd->getAdjList().size(); i++) {
       auto edgA = nd->getAdjList()[i];
       for (size_t j = i + 1; j < nd->getAdjList().size(); j++) {
@@ -537,16 +736,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
         // note: we can identify pairs of edges by the edges only as we dont
         // have a multigraph - we dont need the need for uniqueness
 
-        size_t sharedLines = 0;
-        // TODO: not all lines in getChilds are equal, take the "right" end of
-        // the childs here!
-        for (auto lo : edgA->pl().getChilds().front()->pl().getLines()) {
-          if (edgB->pl().getChilds().front()->pl().hasLine(lo.line)) {
-            sharedLines++;
-          }
-        }
-
-        if (!sharedLines) continue;
+        if (!sharesLines(edgA, edgB)) continue;
 
         std::stringstream negVar;
         negVar << "negdist(" << edgA << "," << edgB << ")";
@@ -560,17 +750,12 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
         int row2 = lp->addRow(constName.str() + "up", gg->maxDeg() - 1,
                               shared::optim::UP);
 
-        std::stringstream dirNameA;
-        dirNameA << "d(" << nd << "," << edgA << ")";
-        std::stringstream dirNameB;
-        dirNameB << "d(" << nd << "," << edgB << ")";
-
-        int colA = lp->getVarByName(dirNameA.str());
+        int colA = idx->getDirCol(nd, edgA);
         assert(colA > -1);
         lp->addColToRow(row1, colA, 1);
         lp->addColToRow(row2, colA, 1);
 
-        int colB = lp->getVarByName(dirNameB.str());
+        int colB = idx->getDirCol(nd, edgB);
         assert(colB > -1);
         lp->addColToRow(row1, colB, -1);
         lp->addColToRow(row2, colB, -1);
@@ -620,6 +805,51 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
   return lp;
 }
 
+// _____________________________________________________________________________
+int ColIdx::getEdgUseCol(const GridEdge* e, const CombEdge* cg) const {
+  auto i = edgUse.find(cg);
+  if (i == edgUse.end()) return -1;
+  auto j = i->second.find(e);
+  if (j == i->second.end()) return -1;
+  return j->second;
+}
+
+// _____________________________________________________________________________
+int ColIdx::getStatPosCol(const GridNode* n, const CombNode* cg) const {
+  auto i = statPos.find(cg);
+  if (i == statPos.end()) return -1;
+  auto j = i->second.find(n);
+  if (j == i->second.end()) return -1;
+  return j->second;
+}
+
+// _____________________________________________________________________________
+int ColIdx::getDirCol(const CombNode* n, const CombEdge* cg) const {
+  auto i = dir.find({n, cg});
+  if (i == dir.end()) return -1;
+  return i->second;
+}
+
+// _____________________________________________________________________________
+CrossIdx::CrossIdx(const CrossEdgPairs& crossPairs) : pairs(crossPairs) {
+  for (size_t i = 0; i < pairs.size(); i++) {
+    for (auto e : {pairs[i].first.first, pairs[i].first.second,
+                   pairs[i].second.first, pairs[i].second.second}) {
+      auto& ePairs = edgPairs[e];
+      // the edge pairs may consist of the same edge twice
+      if (ePairs.empty() || ePairs.back() != i) ePairs.push_back(i);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+const std::vector<size_t>& CrossIdx::getEdgePairs(const GridEdge* e) const {
+  static const std::vector<size_t> none;
+  auto i = edgPairs.find(e);
+  if (i == edgPairs.end()) return none;
+  return i->second;
+}
+
 // _____________________________________________________________________________
 std::string ILPGridOptimizer::getEdgUseVar(const GridEdge* e,
                                            const CombEdge* cg) const {
@@ -641,46 +871,33 @@ std::string ILPGridOptimizer::getStatPosVar(const GridNode* n,
 
 // _____________________________________________________________________________
 void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
-                                       const CombGraph& cg,
+                                       const CombGraph& cg, const ColIdx& idx,
+                                       const Window* win,
                                        combgraph::Drawing* d) const {
   std::map<const CombNode*, const GridNode*> gridNds;
   std::map<const CombEdge*, std::set<const GridEdge*>> gridEdgs;
 
-  // write solution to grid graph
-  for (GridNode* n : gg->getNds()) {
-    for (GridEdge* e : n->getAdjList()) {
-      if (e->getFrom() != n) continue;
-
-      for (auto nd : cg.getNds()) {
-        for (auto edg : nd->getAdjList()) {
-          if (edg->getFrom() != nd) continue;
-          auto varName = getEdgUseVar(e, edg);
-
-          int i = lp->getVarByName(varName);
-          if (i > -1) {
-            double val = lp->getVarVal(i);
-            if (val > 0.5) {
-              gg->addResEdg(e, edg);
-              gridEdgs[edg].insert(e);
-            }
-          }
+  // write solution to grid graph, only the columns which exist have to be
+  // checked
+  for (auto nd : cg.getNds()) {
+    for (auto edg : nd->getAdjList()) {
+      if (edg->getFrom() != nd) continue;
+      auto cols = idx.edgUse.find(edg);
+      if (cols == idx.edgUse.end()) continue;
+
+      for (const auto& col : cols->second) {
+        if (lp->getVarVal(col.second) > 0.5) {
+          auto e = const_cast<GridEdge*>(col.first);
+          gg->addResEdg(e, edg);
+          gridEdgs[edg].insert(e);
         }
       }
     }
   }
 
-  for (GridNode* n : gg->getNds()) {
-    if (!n->pl().isSink()) continue;
-    for (auto nd : cg.getNds()) {
-      auto varName = getStatPosVar(n, nd);
-
-      int i = lp->getVarByName(varName);
-      if (i > -1) {
-        double val = lp->getVarVal(i);
-        if (val > 0.5) {
-          gridNds[nd] = n;
-        }
-      }
+  for (const auto& cols : idx.statPos) {
+    for (const auto& col : cols.second) {
+      if (lp->getVarVal(col.second) > 0.5) gridNds[cols.first] = col.first;
     }
   }
 
@@ -688,6 +905,8 @@ void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
   for (auto nd : cg.getNds()) {
     for (auto edg : nd->getAdjList()) {
       if (edg->getFrom() != nd) continue;
+      // the drawing outside of a window is kept
+      if (win && !win->edgs.count(edg)) continue;
 
       std::vector<GridEdge*> edges(gridEdgs[edg].size());
 
@@ -746,20 +965,25 @@ size_t ILPGridOptimizer::nonInfDeg(const GridNode* g) const {
 // _____________________________________________________________________________
 StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
                                                 const CombGraph& cg,
-                                                double maxGrDist) const {
+                                                double maxGrDist,
+                                                const Corridor* corr,
+                                                const Window* win) const {
   StarterSol sol;
 
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
-    auto settled = gg->getSettled(nd);
+    if (win && !win->nds.count(nd)) continue;
 
-    for (auto gnd : gg->getNds()) {
-      if (!gnd->pl().isSink()) continue;
-      double gridD = dist(*nd->pl().getGeom(), *gnd->pl().getGeom());
+    // the grid of a window is already opened, take the position from the
+    // drawing
+    auto settled = win ? d->getGrNd(nd) : gg->getSettled(nd);
 
-      // threshold for speedup
-      double maxDis = gg->getCellSize() * maxGrDist;
-      if (gridD >= maxDis) continue;
+    // threshold for speedup
+    double maxDis = gg->getCellSize() * maxGrDist;
+
+    for (auto gnd : gg->getGridNdsInRad(*nd->pl().getGeom(), maxDis)) {
+      if (!gnd->pl().isSink()) continue;
+      if (!inCorridor(gnd, corr)) continue;
 
       auto varName = getStatPosVar(gnd, nd);
       if (gnd == settled) {
@@ -773,6 +997,7 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
             if (!bendEdg->pl().isSecondary()) continue;
             for (auto cEdg : nd->getAdjList()) {
               if (cEdg->getFrom() != nd) continue;
+              if (win && !win->edgs.count(cEdg)) continue;
               auto varName = getEdgUseVar(bendEdg, cEdg);
               sol[varName] = 0;
             }
@@ -787,6 +1012,7 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
           assert(sinkEdg->pl().isSecondary());
           for (auto cEdg : nd->getAdjList()) {
             if (cEdg->getFrom() != nd) continue;
+            if (win && !win->edgs.count(cEdg)) continue;
             auto varName = getEdgUseVar(sinkEdg, cEdg);
             sol[varName] = 0;
           }
@@ -796,13 +1022,15 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
   }
 
   // init edge use vars to 0
-  for (auto grNd : gg->getNds()) {
+  for (auto grNd : getCorridorNds(gg, corr)) {
     for (auto grEdg : grNd->getAdjListOut()) {
       if (grEdg->pl().isSecondary()) continue;
+      if (!inCorridor(grEdg->getTo(), corr)) continue;
 
       for (auto cNd : cg.getNds()) {
         for (auto cEdg : cNd->getAdjList()) {
           if (cEdg->getFrom() != cNd) continue;
+          if (win && !win->edgs.count(cEdg)) continue;
           auto varName = getEdgUseVar(grEdg, cEdg);
           sol[varName] = 0;
         }
@@ -813,6 +1041,7 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
   // write edge use vars from heuristic solution
   for (const auto& a : d->getEdgPaths()) {
     auto cEdg = a.first;
+    if (win && !win->edgs.count(cEdg)) continue;
     const auto& grEdgList = a.second;
     for (auto xy : grEdgList) {
       auto grEdg = gg->getGrEdgById(xy);
@@ -825,3 +1054,316 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
   // typically be filled by the solver using the information given above
   return sol;
 }
+
+// _____________________________________________________________________________
+std::vector<const GridNode*> ILPGridOptimizer::getDrawingCells(
+    const Drawing* d, const BaseGraph* gg, const CombGraph& cg) const {
+  std::set<const GridNode*> cells;
+
+  for (auto nd : cg.getNds()) {
+    auto settled = gg->getSettled(nd);
+    if (settled) cells.insert(settled);
+  }
+
+  for (const auto& a : d->getEdgPaths()) {
+    for (auto xy : a.second) {
+      for (auto id : {xy.first, xy.second}) {
+        auto n = gg->getGrNdById(id);
+        cells.insert(n->pl().getParent() ? n->pl().getParent() : n);
+      }
+    }
+  }
+
+  return std::vector<const GridNode*>(cells.begin(), cells.end());
+}
+
+// _____________________________________________________________________________
+bool ILPGridOptimizer::writeCorridor(const BaseGraph* gg,
+                                     const std::vector<const GridNode*>& core,
+                                     double width, Corridor* corr) const {
+  corr->clear();
+
+  // include cells lying exactly on the corridor border
+  double rad = (width + 0.5) * gg->getCellSize();
+
+  for (auto cell : core) {
+    for (auto n : gg->getGridNdsInRad(*cell->pl().getGeom(), rad)) {
+      corr->insert(n);
+    }
+  }
+
+  size_t numCells = 0;
+  for (auto n : gg->getNds()) {
+    if (n->pl().isSink()) numCells++;
+  }
+
+  // false if the corridor already covers the full grid
+  return corr->size() < numCells;
+}
+
+// _____________________________________________________________________________
+bool ILPGridOptimizer::inCorridor(const GridNode* n,
+                                  const Corridor* corr) const {
+  if (!corr) return true;
+  const GridNode* cell = n->pl().getParent() ? n->pl().getParent() : n;
+  return corr->count(cell);
+}
+
+// _____________________________________________________________________________
+std::vector<GridNode*> ILPGridOptimizer::getCorridorNds(
+    BaseGraph* gg, const Corridor* corr) const {
+  if (!corr) {
+    const auto& nds = gg->getNds();
+    return std::vector<GridNode*>(nds.begin(), nds.end());
+  }
+
+  std::vector<GridNode*> ret;
+  for (auto cell : *corr) {
+    ret.push_back(const_cast<GridNode*>(cell));
+    for (size_t p = 0; p < gg->maxDeg(); p++) {
+      // ports may be pruned
+      if (cell->pl().getPort(p)) ret.push_back(cell->pl().getPort(p));
+    }
+  }
+
+  // the corridor is unordered, keep the problem deterministic
+  std::sort(ret.begin(), ret.end(), [](const GridNode* a, const GridNode* b) {
+    return a->pl().getId() < b->pl().getId();
+  });
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+std::vector<Window> ILPGridOptimizer::getWindows(
+    BaseGraph* gg, const CombGraph& cg, Drawing* d, double size, size_t batch,
+    const CrossIdx& crossIdx) const {
+  // the plane is divided into square blocks of half the window size, each
+  // window covers 2x2 blocks. Windows start at every block, so that
+  // neighboring windows overlap by half. The windows of a batch start at
+  // every second block in both directions and are thus disjoint, and every
+  // comb node lies in exactly one window of each batch.
+  double step = std::max(1.0, size / 2) * gg->getCellSize();
+  int bx = batch % 2;
+  int by = batch / 2;
+
+  auto block = [step](const GridNode* n) {
+    return std::pair<int, int>(
+        static_cast<int>(std::floor(n->pl().getGeom()->getX() / step)),
+        static_cast<int>(std::floor(n->pl().getGeom()->getY() / step)));
+  };
+
+  auto winStart = [](int b, int parity) {
+    return ((b % 2) + 2) % 2 == parity ? b : b - 1;
+  };
+
+  std::map<std::pair<int, int>, std::vector<const GridNode*>> blocks;
+  for (auto n : gg->getNds()) {
+    if (!n->pl().isSink()) continue;
+    blocks[block(n)].push_back(n);
+  }
+
+  std::map<std::pair<int, int>, Window> wins;
+  for (auto nd : cg.getNds()) {
+    if (nd->getDeg() == 0) continue;
+    auto b = block(d->getGrNd(nd));
+    wins[{winStart(b.first, bx), winStart(b.second, by)}].nds.insert(nd);
+  }
+
+  const auto& paths = d->getEdgPaths();
+
+  // the comb edges whose path passes through a cell, so that each window
+  // only visits the paths inside of it
+  std::unordered_map<const GridNode*, std::vector<const CombEdge*>> cellPaths;
+  for (const auto& p : paths) {
+    for (auto xy : p.second) {
+      for (auto id : {xy.first, xy.second}) {
+        auto n = gg->getGrNdById(id);
+        auto& cp = cellPaths[n->pl().getParent() ? n->pl().getParent() : n];
+        if (cp.empty() || cp.back() != p.first) cp.push_back(p.first);
+      }
+    }
+  }
+
+  std::vector<Window> ret;
+
+  for (auto& w : wins) {
+    auto& win = w.second;
+
+    for (auto nd : win.nds) {
+      for (auto edg : nd->getAdjList()) {
+        if (win.nds.count(edg->getOtherNd(nd))) {
+          win.edgs.insert(edg);
+        } else {
+          win.fixed[nd] = d->getGrNd(nd);
+        }
+      }
+    }
+
+    if (win.edgs.empty()) continue;
+
+    Corridor box;
+    for (int x = 0; x < 2; x++) {
+      for (int y = 0; y < 2; y++) {
+        auto b = blocks.find({w.first.first + x, w.first.second + y});
+        if (b == blocks.end()) continue;
+        box.insert(b->second.begin(), b->second.end());
+      }
+    }
+
+    win.cells = box;
+
+    std::set<const CombEdge*> winPaths;
+    for (auto cell : box) {
+      auto cp = cellPaths.find(cell);
+      if (cp == cellPaths.end()) continue;
+      winPaths.insert(cp->second.begin(), cp->second.end());
+    }
+
+    // block the fixed paths inside the window, together with the cells they
+    // pass through
+    for (auto cEdg : winPaths) {
+      if (win.edgs.count(cEdg)) continue;
+
+      auto frCell = d->getGrNd(cEdg->getFrom());
+      auto toCell = d->getGrNd(cEdg->getTo());
+
+      for (auto xy : paths.find(cEdg)->second) {
+        auto e = gg->getGrEdgById(xy);
+        if (!inCorridor(e->getFrom(), &box) && !inCorridor(e->getTo(), &box)) {
+          continue;
+        }
+
+        win.blocked.insert(e);
+        win.blocked.insert(gg->getEdg(e->getTo(), e->getFrom()));
+
+        for (auto n : {e->getFrom(), e->getTo()}) {
+          auto cell = n->pl().getParent() ? n->pl().getParent() : n;
+          if (cell != frCell && cell != toCell) win.cells.erase(cell);
+        }
+      }
+    }
+
+    // block grid edges crossing the fixed paths
+    std::unordered_set<const GridEdge*> crossing;
+    for (auto e : win.blocked) {
+      for (size_t pairId : crossIdx.getEdgePairs(e)) {
+        const auto& cp = crossIdx.pairs[pairId];
+        if (cp.first.first == e || cp.first.second == e) {
+          crossing.insert(cp.second.first);
+          crossing.insert(cp.second.second);
+        }
+        if (cp.second.first == e || cp.second.second == e) {
+          crossing.insert(cp.first.first);
+          crossing.insert(cp.first.second);
+        }
+      }
+    }
+    win.blocked.insert(crossing.begin(), crossing.end());
+
+    bool ok = true;
+    for (const auto& f : win.fixed) {
+      for (auto edg : f.first->getAdjList()) {
+        if (win.edgs.count(edg)) continue;
+        int port = getPort(gg, f.second, paths.find(edg)->second);
+        if (port < 0) ok = false;
+        win.fixedDirs[{f.first, edg}] = port;
+      }
+    }
+
+    if (!ok) {
+      LOGTO(DEBUG, std::cerr) << "Skipping window with unknown ports";
+      continue;
+    }
+
+    ret.push_back(win);
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+int ILPGridOptimizer::getPort(const BaseGraph* gg, const GridNode* cell,
+                              const combgraph::GrPath& pth) const {
+  if (pth.empty()) return -1;
+
+  for (auto id : {pth.front().first, pth.front().second, pth.back().first,
+                  pth.back().second}) {
+    auto n = gg->getGrNdById(id);
+    if (n->pl().getParent() != cell) continue;
+    for (size_t p = 0; p < gg->maxDeg(); p++) {
+      if (cell->pl().getPort(p) == n) return p;
+    }
+  }
+
+  return -1;
+}
+
+// _____________________________________________________________________________
+double ILPGridOptimizer::getCost(BaseGraph* gg, Drawing* d,
+                                 const GeoPensMap* geoPensMap,
+                                 const std::set<const CombNode*>& nds,
+                                 const std::set<const CombEdge*>& edgs) const {
+  const auto& paths = d->getEdgPaths();
+  double ret = 0;
+
+  for (auto edg : edgs) {
+    auto pth = paths.find(edg);
+    if (pth == paths.end()) return std::numeric_limits<double>::infinity();
+
+    // the path is stored from its end to its start, sink edges are free
+    const auto& xys = pth->second;
+    for (size_t i = 0; i < xys.size(); i++) {
+      auto e = gg->getGrEdgById(xys[i]);
+      ret += e->pl().cost();
+      if (geoPensMap) {
+        ret += geoPensMap->find(edg)->second.get(e->pl().getId(),
+                                                 octi::basegraph::SOFT_INF);
+      }
+
+      // the bend edge in the cell entered by the previous grid edge
+      if (i + 1 < xys.size() && xys[i + 1].second != xys[i].first) {
+        auto bend = gg->getEdg(gg->getGrNdById(xys[i + 1].second),
+                               gg->getGrNdById(xys[i].first));
+        if (bend) ret += bend->pl().cost();
+      }
+    }
+  }
+
+  std::vector<double> pens = gg->getCosts();
+  int M = pens.size();
+  int D = gg->maxDeg();
+
+  for (auto nd : nds) {
+    auto cell = d->getGrNd(nd);
+    ret += gg->ndMovePen(nd, cell);
+
+    // angle penalties, as encoded by the d variables of the ILP
+    for (size_t i = 0; i < nd->getAdjList().size(); i++) {
+      auto edgA = nd->getAdjList()[i];
+      for (size_t j = i + 1; j < nd->getAdjList().size(); j++) {
+        auto edgB = nd->getAdjList()[j];
+        if (!sharesLines(edgA, edgB)) continue;
+
+        int a = getPort(gg, cell, paths.find(edgA)->second);
+        int b = getPort(gg, cell, paths.find(edgB)->second);
+        if (a < 0 || b < 0 || a == b) continue;
+
+        int k = (a - b + D) % D - 1;
+        ret += pens[k < M ? M - 1 - k : k + 1 - M];
+      }
+    }
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+bool ILPGridOptimizer::sharesLines(const CombEdge* a, const CombEdge* b) const {
+  // TODO: not all lines in getChilds are equal, take the "right" end of
+  // the childs here!
+  for (auto lo : a->pl().getChilds().front()->pl().getLines()) {
+    if (b->pl().getChilds().front()->pl().hasLine(lo.line)) return true;
+  }
+  return false;
+}
@@ -5,6 +5,11 @@
 #ifndef OCTI_ILP_ILPGRIDOPTIMIZER_H_
 #define OCTI_ILP_ILPGRIDOPTIMIZER_H_
 
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/combgraph/CombGraph.h"
@@ -43,6 +48,55 @@ inline ILPStats operator+(const ILPStats& lh, const ILPStats& rh) {
   return ret;
 }
 
+// grid cells (center nodes) the ILP is restricted to
+typedef std::unordered_set<const GridNode*> Corridor;
+
+// part of the drawing re-optimized by a single windowed ILP, everything
+// outside of it stays fixed
+struct Window {
+  // the comb nodes placed inside the window, and the comb edges between them
+  std::set<const CombNode*> nds;
+  std::set<const CombEdge*> edgs;
+
+  // window nodes with an edge leaving the window keep their grid cell, the
+  // leaving edges keep their port there
+  std::map<const CombNode*, const GridNode*> fixed;
+  std::map<std::pair<const CombNode*, const CombEdge*>, size_t> fixedDirs;
+
+  // the grid cells the window may use, and the grid edges blocked by the
+  // fixed part of the drawing
+  Corridor cells;
+  std::unordered_set<const GridEdge*> blocked;
+};
+
+// integer keyed column index of the grid ILP, so that neither the problem
+// construction nor the solution extraction has to resolve variable names
+struct ColIdx {
+  std::unordered_map<const CombEdge*,
+                     std::unordered_map<const GridEdge*, int>>
+      edgUse;
+  std::unordered_map<const CombNode*,
+                     std::unordered_map<const GridNode*, int>>
+      statPos;
+  std::map<std::pair<const CombNode*, const CombEdge*>, int> dir;
+
+  int getEdgUseCol(const GridEdge* e, const CombEdge* cg) const;
+  int getStatPosCol(const GridNode* n, const CombNode* cg) const;
+  int getDirCol(const CombNode* n, const CombEdge* cg) const;
+};
+
+// the crossing grid edge pairs of a base graph, indexed by the edges they
+// consist of
+struct CrossIdx {
+  explicit CrossIdx(const basegraph::CrossEdgPairs& crossPairs);
+
+  basegraph::CrossEdgPairs pairs;
+  std::unordered_map<const GridEdge*, std::vector<size_t>> edgPairs;
+
+  // the positions in pairs of the crossings edge e is part of
+  const std::vector<size_t>& getEdgePairs(const GridEdge* e) const;
+};
+
 class ILPGridOptimizer {
  public:
   ILPGridOptimizer() {}
@@ -51,25 +105,78 @@ class ILPGridOptimizer {
                     double maxGrDist, bool noSolve,
                     const basegraph::GeoPensMap* geoPensMap, int timeLim,
                     const std::string& cacheDir, double cacheThreshold,
-                    int numThreads, const std::string& solverStr,
+                    int numThreads, double relGap, double corridor,
+                    const std::string& solverStr,
+                    const std::string& solverProfile,
                     const std::string& path) const;
 
+  // re-optimize the drawing d in overlapping windows of window x window grid
+  // cells, with everything outside the current window fixed, until no window
+  // improves anymore. Disjoint windows are solved by up to jobs parallel
+  // solvers.
+  ILPStats optimizeWindowed(BaseGraph* gg, const CombGraph& cg,
+                            combgraph::Drawing* d, double maxGrDist,
+                            const basegraph::GeoPensMap* geoPensMap,
+                            int timeLim, const std::string& cacheDir,
+                            double cacheThreshold, int numThreads,
+                            double relGap, double window, size_t jobs,
+                            const std::string& solverStr,
+                            const std::string& solverProfile) const;
+
  protected:
   shared::optim::ILPSolver* createProblem(
       BaseGraph* gg, const CombGraph& cg,
       const basegraph::GeoPensMap* geoPensMap, double maxGrDist,
-      const std::string& solverStr) const;
+      const Corridor* corr, const Window* win, const CrossIdx& crossIdx,
+      const std::string& solverStr, const std::string& solverProfile,
+      ColIdx* idx) const;
 
   std::string getEdgUseVar(const GridEdge* e, const CombEdge* cg) const;
   std::string getStatPosVar(const GridNode* e, const CombNode* cg) const;
 
   void extractSolution(shared::optim::ILPSolver* lp, BaseGraph* gg,
-                       const CombGraph& cg, combgraph::Drawing* d) const;
+                       const CombGraph& cg, const ColIdx& idx,
+                       const Window* win, combgraph::Drawing* d) const;
 
   shared::optim::StarterSol extractFeasibleSol(combgraph::Drawing* d,
                                                BaseGraph* gg,
                                                const CombGraph& cg,
-                                               double maxGrDist) const;
+                                               double maxGrDist,
+                                               const Corridor* corr,
+                                               const Window* win) const;
+
+  void openGrid(BaseGraph* gg) const;
+
+  std::vector<Window> getWindows(BaseGraph* gg, const CombGraph& cg,
+                                 combgraph::Drawing* d, double size,
+                                 size_t batch, const CrossIdx& crossIdx)
+      const;
+
+  // the port of cell through which the path pth enters or leaves it, or -1
+  int getPort(const BaseGraph* gg, const GridNode* cell,
+              const combgraph::GrPath& pth) const;
+
+  // the objective value the ILP would assign to the current drawing of nds
+  // and edgs, expects an opened grid
+  double getCost(BaseGraph* gg, combgraph::Drawing* d,
+                 const basegraph::GeoPensMap* geoPensMap,
+                 const std::set<const CombNode*>& nds,
+                 const std::set<const CombEdge*>& edgs) const;
+
+  bool sharesLines(const CombEdge* a, const CombEdge* b) const;
+
+  std::vector<const GridNode*> getDrawingCells(const combgraph::Drawing* d,
+                                               const BaseGraph* gg,
+                                               const CombGraph& cg) const;
+  bool writeCorridor(const BaseGraph* gg,
+                     const std::vector<const GridNode*>& core, double width,
+                     Corridor* corr) const;
+  bool inCorridor(const GridNode* n, const Corridor* corr) const;
+
+  // the grid nodes of the cells in corr and their ports, ordered by id, or
+  // all grid nodes if corr is null
+  std::vector<GridNode*> getCorridorNds(BaseGraph* gg,
+                                        const Corridor* corr) const;
 
   size_t nonInfDeg(const GridNode* g) const;
 };
@@ -1495,6 +1495,30 @@ std::vector<LineGraph> LineGraph::distConnectedComponents(double d, bool write,
 
   if (offset) idOffset = *offset;
 
+  const auto& geoComps = distConnectedNdSets(d);
+
+  ret.resize(geoComps.size());
+
+  for (size_t comp = 0; comp < geoComps.size(); comp++) {
+    if (write) {
+      for (auto nd : geoComps[comp]) {
+        nd->pl().setComponent(idOffset + comp);
+        for (auto edg : nd->getAdjList()) {
+          if (edg->getFrom() == nd) edg->pl().setComponent(idOffset + comp);
+        }
+      }
+    }
+
+    extractComp(geoComps[comp], &ret[comp]);
+  }
+
+  if (offset) *offset = idOffset + geoComps.size() + 1;
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+std::vector<std::set<LineNode*>> LineGraph::distConnectedNdSets(double d) {
   // first pass, collect components
   const auto& origComps = Algorithm::connectedComponents(*this);
   std::unordered_map<LineNode*, size_t> ndToComp;
@@ -1528,45 +1552,44 @@ std::vector<LineGraph> LineGraph::distConnectedComponents(double d, bool write,
     delEdg(e->getFrom(), e->getTo());
   }
 
-  ret.resize(geoComps.size());
-
-  for (size_t comp = 0; comp < geoComps.size(); comp++) {
-    auto* tg = &ret[comp];
+  std::vector<std::set<LineNode*>> ret;
+  for (const auto& comp : geoComps) {
+    ret.push_back(std::set<LineNode*>(comp.begin(), comp.end()));
+  }
 
-    std::unordered_map<LineNode*, LineNode*> nm;
-    std::unordered_map<LineEdge*, LineEdge*> em;
+  return ret;
+}
 
-    // add nodes
-    for (auto nd : geoComps[comp]) {
-      if (write) nd->pl().setComponent(idOffset + comp);
-      nm[nd] = tg->addNd(nd->pl());
-      tg->expandBBox(*nd->pl().getGeom());
-    }
+// _____________________________________________________________________________
+void LineGraph::extractComp(const std::set<LineNode*>& nds,
+                            LineGraph* tg) const {
+  std::unordered_map<LineNode*, LineNode*> nm;
+  std::unordered_map<LineEdge*, LineEdge*> em;
+
+  // add nodes
+  for (auto nd : nds) {
+    nm[nd] = tg->addNd(nd->pl());
+    tg->expandBBox(*nd->pl().getGeom());
+  }
 
-    // add edges
-    for (auto nd : geoComps[comp]) {
-      for (auto edg : nd->getAdjList()) {
-        if (edg->getFrom() != nd) continue;
-        if (write) edg->pl().setComponent(idOffset + comp);
-        if (edg->pl().getLines().size() == 0) {
-          continue;
-        }
+  // add edges
+  for (auto nd : nds) {
+    for (auto edg : nd->getAdjList()) {
+      if (edg->getFrom() != nd) continue;
+      if (edg->pl().getLines().size() == 0) {
+        continue;
+      }
 
-        em[edg] = tg->addEdg(nm[edg->getFrom()], nm[edg->getTo()], edg->pl());
-        tg->expandBBox(edg->pl().getGeom()->front());
-        tg->expandBBox(edg->pl().getGeom()->back());
+      em[edg] = tg->addEdg(nm[edg->getFrom()], nm[edg->getTo()], edg->pl());
+      tg->expandBBox(edg->pl().getGeom()->front());
+      tg->expandBBox(edg->pl().getGeom()->back());
 
-        tg->edgeRpl(em[edg]->getFrom(), edg, em[edg]);
-        tg->edgeRpl(em[edg]->getTo(), edg, em[edg]);
-        tg->nodeRpl(em[edg], edg->getTo(), nm[edg->getTo()]);
-        tg->nodeRpl(em[edg], edg->getFrom(), nm[edg->getFrom()]);
-      }
+      tg->edgeRpl(em[edg]->getFrom(), edg, em[edg]);
+      tg->edgeRpl(em[edg]->getTo(), edg, em[edg]);
+      tg->nodeRpl(em[edg], edg->getTo(), nm[edg->getTo()]);
+      tg->nodeRpl(em[edg], edg->getFrom(), nm[edg->getFrom()]);
     }
   }
-
-  if (offset) *offset = idOffset + geoComps.size() + 1;
-
-  return ret;
 }
 
 // _____________________________________________________________________________
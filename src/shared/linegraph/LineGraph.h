@@ -170,6 +170,13 @@ class LineGraph : public util::graph::UndirGraph<LineNodePL, LineEdgePL> {
   std::vector<LineGraph> distConnectedComponents(double d, bool write,
                                                  size_t* offset);
 
+  // the node sets of the components of distConnectedComponents(d, ...), in
+  // the same order
+  std::vector<std::set<LineNode*>> distConnectedNdSets(double d);
+
+  // copies the subgraph induced by nds (a component of this graph) into tg
+  void extractComp(const std::set<LineNode*>& nds, LineGraph* tg) const;
+
   void fillMissingColors();
 
   void removeDeg1Nodes();
@@ -5,10 +5,12 @@
 #ifdef COIN_FOUND
 
 #include <cassert>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
 // COIN includes
+#include "CbcEventHandler.hpp"
 #include "CbcSolver.hpp"
 #include "CoinPragma.hpp"
 #include "CoinWarmStart.hpp"
@@ -22,7 +24,10 @@
 
 using shared::optim::COINSolver;
 using shared::optim::DirType;
+using shared::optim::ILPSolver;
+using shared::optim::SolveProgress;
 using shared::optim::SolveType;
+using shared::optim::SolverProfile;
 
 // _____________________________________________________________________________
 int callBack(CbcModel* model, int from) {
@@ -44,12 +49,47 @@ int callBack(CbcModel* model, int from) {
   return ret;
 }
 
+// forwards CBC branch & bound events to the progress callback of a solver
+class ProgressHandler : public CbcEventHandler {
+ public:
+  ProgressHandler(ILPSolver* solver) : CbcEventHandler(), _solver(solver) {}
+  ProgressHandler(const ProgressHandler& rhs)
+      : CbcEventHandler(rhs), _solver(rhs._solver) {}
+
+  CbcEventHandler* clone() const { return new ProgressHandler(*this); }
+
+  CbcAction event(CbcEvent whichEvent) {
+    if (whichEvent != node && whichEvent != solution &&
+        whichEvent != heuristicSolution) {
+      return noAction;
+    }
+
+    SolveProgress p;
+    p.incumbent = model_->bestSolution()
+                      ? model_->getObjValue()
+                      : std::numeric_limits<double>::infinity();
+    p.bound = model_->getBestPossibleObjValue();
+    p.gap = ILPSolver::relGap(p.incumbent, p.bound);
+    p.nodes = model_->getNodeCount();
+    p.time = model_->getCurrentSeconds() * 1000;
+
+    _solver->reportProgress(p, whichEvent != node);
+
+    return noAction;
+  }
+
+ private:
+  ILPSolver* _solver;
+};
+
 // _____________________________________________________________________________
 COINSolver::COINSolver(DirType dir)
     : _starterArr(0),
       _status(INF),
       _timeLimit(std::numeric_limits<int>::max()),
       _numThreads(0),
+      _profile(GENERIC),
+      _relGapLim(0),
       _msgHandler(stderr) {
   _solver = &_solver1;
 
@@ -178,6 +218,9 @@ SolveType COINSolver::solve() {
   _cbcModel.setMaximumSeconds(_timeLimit);
   _cbcModel.setUseElapsedTime(true);
 
+  ProgressHandler progress(this);
+  _cbcModel.passInEventHandler(&progress);
+
   // this basically follows the examle given at
   // https://github.com/coin-or/Cbc/blob/879602724a65987c5cfb0b9fbacfa192c93df42c/examples/driver6.cpp
   //
@@ -201,8 +244,17 @@ SolveType COINSolver::solve() {
 
   if (_numThreads > 0) numThreads = std::to_string(_numThreads);
 
-  const char* argv2[] = {"-solve", "-threads", numThreads.c_str()};
-  CbcMain1(3, argv2, _cbcModel, callBack, solverData);
+  std::string gap = std::to_string(_relGapLim);
+
+  std::vector<const char*> argv2 = {"-solve", "-threads", numThreads.c_str()};
+  if (_relGapLim > 0) {
+    argv2.push_back("-ratioGap");
+    argv2.push_back(gap.c_str());
+  }
+  applyProfile(&argv2);
+
+  CbcMain1(static_cast<int>(argv2.size()), argv2.data(), _cbcModel, callBack,
+           solverData);
   _solver = _cbcModel.solver();
 
   if (_cbcModel.isProvenOptimal())
@@ -270,6 +322,46 @@ void COINSolver::setNumThreads(int n) {
 // _____________________________________________________________________________
 int COINSolver::getNumThreads() const { return _numThreads; }
 
+// _____________________________________________________________________________
+void COINSolver::setProfile(SolverProfile p) { _profile = p; }
+
+// _____________________________________________________________________________
+void COINSolver::applyProfile(std::vector<const char*>* argv) const {
+  // the parameters are given as on the cbc command line
+  switch (_profile) {
+    case LOOM_ORDERING:
+      // pure binary assignment models: the preprocessor shrinks them well,
+      // the assignment rows give strong clique cuts, and the feasibility pump
+      // finds integral orderings quickly
+      argv->insert(argv->end(), {"-preprocess", "on", "-cliqueCuts", "ifmove",
+                                 "-gomoryCuts", "on", "-feasibilityPump",
+                                 "on"});
+      break;
+    case OCTI_GRID:
+      // huge numbers of binary edge usage columns over flow rows. CBC gets
+      // no start solution, so the incumbent has to be found by the
+      // heuristics, proximity search and RINS then improve it
+      argv->insert(argv->end(),
+                   {"-preprocess", "on", "-mixedIntegerRoundingCuts", "on",
+                    "-feasibilityPump", "on", "-proximitySearch", "on",
+                    "-rins", "on"});
+      break;
+    case GENERIC:
+    default:
+      // cbc command line defaults
+      break;
+  }
+}
+
+// _____________________________________________________________________________
+SolverProfile COINSolver::getProfile() const { return _profile; }
+
+// _____________________________________________________________________________
+void COINSolver::setRelGapLim(double gap) { _relGapLim = gap; }
+
+// _____________________________________________________________________________
+double COINSolver::getRelGapLim() const { return _relGapLim; }
+
 // _____________________________________________________________________________
 void COINSolver::writeMps(const std::string& path) const {
   _model.writeMps(path.c_str());
@@ -65,6 +65,12 @@ class COINSolver : public ILPSolver {
   void setNumThreads(int n);
   int getNumThreads() const;
 
+  void setProfile(SolverProfile p);
+  SolverProfile getProfile() const;
+
+  void setRelGapLim(double gap);
+  double getRelGapLim() const;
+
   void setStarter(const StarterSol& starterSol);
   void writeMps(const std::string& path) const;
 
@@ -79,11 +85,18 @@ class COINSolver : public ILPSolver {
 
   int _numThreads;
 
+  SolverProfile _profile;
+
+  double _relGapLim;
+
   OsiClpSolverInterface _solver1;
   OsiSolverInterface* _solver;
   mutable CoinModel _model;
   CbcModel _cbcModel;
 CoinMessageHandler _msgHandler;
+
+  // appends the CBC command line parameters of the current profile
+  void applyProfile(std::vector<const char*>* argv) const;
 };
 
 }  // namespace optim
@@ -14,14 +14,18 @@
 #include "util/log/Log.h"
 
 using shared::optim::GLPKSolver;
+using shared::optim::SolveProgress;
 using shared::optim::SolveType;
+using shared::optim::SolverProfile;
 using shared::optim::VariableMatrix;
 
 // _____________________________________________________________________________
 GLPKSolver::GLPKSolver(DirType dir)
     : _starterArr(0),
       _status(INF),
-      _timeLimit(std::numeric_limits<int>::max()) {
+      _timeLimit(std::numeric_limits<int>::max()),
+      _profile(GENERIC),
+      _relGapLim(0) {
   const char* ver = glp_version();
   LOGTO(DEBUG, std::cerr) << "Creating GLPK solver v" << ver << " instance...";
 
@@ -178,14 +182,17 @@ SolveType GLPKSolver::solve() {
   params.cb_func = optCb;
   params.cb_info = this;
 
-  // params.presolve = GLP_ON;
-  // params.binarize = GLP_OFF;
   params.ps_tm_lim = 60000;
   params.tm_lim = _timeLimit;
-  // params.fp_heur = GLP_ON;
-  // params.ps_heur = GLP_ON;
 
-  glp_simplex(_prob, &sparams);
+  applyProfile(&params);
+
+  if (_relGapLim > 0) params.mip_gap = _relGapLim;
+
+  _solveStart = std::chrono::steady_clock::now();
+
+  // the MIP presolver solves the LP relaxation itself
+  if (params.presolve != GLP_ON) glp_simplex(_prob, &sparams);
   glp_intopt(_prob, &params);
 
   int optimStat = glp_mip_status(_prob);
@@ -200,6 +207,51 @@ SolveType GLPKSolver::solve() {
   return getStatus();
 }
 
+// _____________________________________________________________________________
+void GLPKSolver::applyProfile(glp_iocp* params) const {
+  switch (_profile) {
+    case LOOM_ORDERING:
+      // all columns are binary, and the models consist mostly of assignment
+      // rows (each line gets exactly one position) and crossing rows over
+      // them. Presolving shrinks them considerably, the feasibility pump finds
+      // integral assignments quickly, and the assignment rows yield strong
+      // clique cuts. No start solution is given, so the presolver can be used.
+      params->presolve = GLP_ON;
+      params->binarize = GLP_OFF;
+      params->fp_heur = GLP_ON;
+      params->clq_cuts = GLP_ON;
+      params->gmi_cuts = GLP_ON;
+      params->br_tech = GLP_BR_PCH;
+      break;
+    case OCTI_GRID:
+      // huge numbers of binary edge usage columns, but always a feasible
+      // start solution from the heuristic drawing. The presolver would
+      // transform the problem and invalidate the start solution, so keep it
+      // disabled and use proximity search to improve the incumbent instead.
+      params->presolve = GLP_OFF;
+      params->ps_heur = GLP_ON;
+      params->mir_cuts = GLP_ON;
+      params->br_tech = GLP_BR_PCH;
+      params->bt_tech = GLP_BT_BPH;
+      break;
+    case GENERIC:
+    default:
+      break;
+  }
+}
+
+// _____________________________________________________________________________
+void GLPKSolver::setProfile(SolverProfile p) { _profile = p; }
+
+// _____________________________________________________________________________
+SolverProfile GLPKSolver::getProfile() const { return _profile; }
+
+// _____________________________________________________________________________
+void GLPKSolver::setRelGapLim(double gap) { _relGapLim = gap; }
+
+// _____________________________________________________________________________
+double GLPKSolver::getRelGapLim() const { return _relGapLim; }
+
 // _____________________________________________________________________________
 void GLPKSolver::setTimeLim(int s) { _timeLimit = s * 1000; }
 
@@ -238,11 +290,43 @@ void GLPKSolver::optCb(glp_tree* tree, void* solver) {
         glp_ios_heur_sol(tree, _this->getStarterArr());
       }
       break;
+    case GLP_IBINGO:
+      _this->reportTreeProgress(tree, true);
+      break;
+    case GLP_ISELECT:
+      _this->reportTreeProgress(tree, false);
+      break;
     default:
       break;
   }
 }
 
+// _____________________________________________________________________________
+void GLPKSolver::reportTreeProgress(glp_tree* tree, bool force) {
+  glp_prob* prob = glp_ios_get_prob(tree);
+
+  SolveProgress p;
+  p.time = std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - _solveStart)
+               .count();
+
+  int best = glp_ios_best_node(tree);
+  int stat = glp_mip_status(prob);
+  bool hasInc = stat == GLP_FEAS || stat == GLP_OPT;
+
+  p.incumbent =
+      hasInc ? glp_mip_obj_val(prob) : std::numeric_limits<double>::infinity();
+  p.bound = best ? glp_ios_node_bound(tree, best) : p.incumbent;
+  p.gap = hasInc ? glp_ios_mip_gap(tree)
+                 : std::numeric_limits<double>::infinity();
+
+  int active, cur, total;
+  glp_ios_tree_size(tree, &active, &cur, &total);
+  p.nodes = total;
+
+  ILPSolver::reportProgress(p, force);
+}
+
 // _____________________________________________________________________________
 void GLPKSolver::errorHook(void* info) {
   UNUSED(info);
@@ -8,6 +8,7 @@
 #ifdef GLPK_FOUND
 
 #include <glpk.h>
+#include <chrono>
 #include <vector>
 #include "shared/optim/ILPSolver.h"
 #include "util/Misc.h"
@@ -60,6 +61,12 @@ class GLPKSolver : public ILPSolver {
   void setNumThreads(int n){UNUSED(n);};
   int getNumThreads() const {return 0;};
 
+  void setProfile(SolverProfile p);
+  SolverProfile getProfile() const;
+
+  void setRelGapLim(double gap);
+  double getRelGapLim() const;
+
   void setTimeLim(int s);
   int getTimeLim() const;
 
@@ -84,8 +91,18 @@ class GLPKSolver : public ILPSolver {
 
   int _timeLimit;
 
+  SolverProfile _profile;
+
+  double _relGapLim;
+
+  std::chrono::steady_clock::time_point _solveStart;
+
   std::string _termBuf;
 
+  void applyProfile(glp_iocp* params) const;
+
+  void reportTreeProgress(glp_tree* tree, bool force);
+
   static void optCb(glp_tree* tree, void* solver);
   static int termHook(void* info, const char* str);
   static void errorHook(void* info);
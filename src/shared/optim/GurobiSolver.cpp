@@ -13,11 +13,18 @@
 #include "util/log/Log.h"
 
 using shared::optim::GurobiSolver;
+using shared::optim::SolveProgress;
 using shared::optim::SolveType;
+using shared::optim::SolverProfile;
 
 // _____________________________________________________________________________
 GurobiSolver::GurobiSolver(DirType dir)
-    : _starterArr(0), _status(INF), _numVars(0), _numRows(0) {
+    : _starterArr(0),
+      _status(INF),
+      _profile(GENERIC),
+      _relGapLim(0),
+      _numVars(0),
+      _numRows(0) {
   int verMaj, verMin, verTech;
   GRBversion(&verMaj, &verMin, &verTech);
   LOGTO(DEBUG, std::cerr) << "Creating gurobi v" << verMaj << "." << verMin
@@ -55,7 +62,7 @@ GurobiSolver::GurobiSolver(DirType dir)
     throw std::runtime_error("Could not create gurobi model");
   }
 
-  error = GRBsetcallbackfunc(_model, termHook, &_logBuffer);
+  error = GRBsetcallbackfunc(_model, termHook, this);
 
   if (dir == MAX)
     GRBsetintattr(_model, GRB_INT_ATTR_MODELSENSE, GRB_MAXIMIZE);
@@ -206,7 +213,15 @@ SolveType GurobiSolver::solve() {
     }
   }
 
-  // GRBsetintparam(GRBgetenv(_model), GRB_INT_PAR_PRESOLVE, 2);
+  if (_profile == LOOM_ORDERING) {
+    // the ordering models are dominated by assignment constraints, which
+    // aggressive presolving reduces considerably
+    GRBsetintparam(GRBgetenv(_model), GRB_INT_PAR_PRESOLVE, 2);
+  } else if (_profile == OCTI_GRID) {
+    // the grid models are huge and usually come with a good start solution,
+    // focus on improving it
+    GRBsetintparam(GRBgetenv(_model), GRB_INT_PAR_MIPFOCUS, 1);
+  }
 
   // 10 sec tuning
   // GRBsetdblparam(GRBgetenv(_model), GRB_DBL_PAR_TUNETIMELIMIT, 10);
@@ -220,6 +235,10 @@ SolveType GurobiSolver::solve() {
   // error = GRBgettuneresult(_model, 0);
   // }
 
+  if (_relGapLim > 0) {
+    GRBsetdblparam(GRBgetenv(_model), GRB_DBL_PAR_MIPGAP, _relGapLim);
+  }
+
   error = GRBoptimize(_model);
   if (error) {
     throw std::runtime_error("Could not optimize model");
@@ -327,6 +346,18 @@ int GurobiSolver::getNumThreads() const {
   return ret;
 }
 
+// _____________________________________________________________________________
+void GurobiSolver::setProfile(SolverProfile p) { _profile = p; }
+
+// _____________________________________________________________________________
+SolverProfile GurobiSolver::getProfile() const { return _profile; }
+
+// _____________________________________________________________________________
+void GurobiSolver::setRelGapLim(double gap) { _relGapLim = gap; }
+
+// _____________________________________________________________________________
+double GurobiSolver::getRelGapLim() const { return _relGapLim; }
+
 // _____________________________________________________________________________
 void GurobiSolver::setTimeLim(int s) {
   // set time limit
@@ -412,14 +443,36 @@ void GurobiSolver::writeMps(const std::string& path) const {
 
 // _____________________________________________________________________________
 int GurobiSolver::termHook(GRBmodel* mod, void* cbdata, int where,
-                           void* buffPtr) {
+                           void* solver) {
   UNUSED(mod);
-  if (where == GRB_CB_MESSAGE) {
+  auto _this = reinterpret_cast<GurobiSolver*>(solver);
+
+  if (where == GRB_CB_MIP || where == GRB_CB_MIPSOL) {
+    bool sol = where == GRB_CB_MIPSOL;
+    double inc, bnd, nodes, runtime;
+    int error =
+        GRBcbget(cbdata, where, sol ? GRB_CB_MIPSOL_OBJBST : GRB_CB_MIP_OBJBST,
+                 &inc) ||
+        GRBcbget(cbdata, where, sol ? GRB_CB_MIPSOL_OBJBND : GRB_CB_MIP_OBJBND,
+                 &bnd) ||
+        GRBcbget(cbdata, where, sol ? GRB_CB_MIPSOL_NODCNT : GRB_CB_MIP_NODCNT,
+                 &nodes) ||
+        GRBcbget(cbdata, where, GRB_CB_RUNTIME, &runtime);
+    if (error) return 0;
+
+    if (std::abs(inc) >= GRB_INFINITY) {
+      inc = std::numeric_limits<double>::infinity();
+    }
+
+    SolveProgress p{inc, bnd, relGap(inc, bnd), static_cast<size_t>(nodes),
+                    runtime * 1000};
+    _this->reportProgress(p, sol);
+  } else if (where == GRB_CB_MESSAGE) {
     const char* msg;
     int error = GRBcbget(cbdata, where, GRB_CB_MSG_STRING, &msg);
     if (error) return 0;
 
-    std::string* buff = reinterpret_cast<std::string*>(buffPtr);
+    std::string* buff = &_this->_logBuffer;
     std::string s = msg;
     for (auto ch : s) {
       if (ch == '\n') {
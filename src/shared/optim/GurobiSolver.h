@@ -57,6 +57,12 @@ class GurobiSolver : public ILPSolver {
   void setNumThreads(int n);
   int getNumThreads() const;
 
+  void setProfile(SolverProfile p);
+  SolverProfile getProfile() const;
+
+  void setRelGapLim(double gap);
+  double getRelGapLim() const;
+
   void writeMps(const std::string& path) const;
 
   void setStarter(const StarterSol& starterSol);
@@ -70,6 +76,10 @@ class GurobiSolver : public ILPSolver {
 
   SolveType _status;
 
+  SolverProfile _profile;
+
+  double _relGapLim;
+
   int _numVars, _numRows;
   std::string _logBuffer;
 
@@ -5,6 +5,8 @@
 #ifndef SHARED_OPTIM_ILPSOLVPROV_H_
 #define SHARED_OPTIM_ILPSOLVPROV_H_
 
+#include <string>
+#include <vector>
 #include "shared/optim/COINSolver.h"
 #include "shared/optim/GLPKSolver.h"
 #include "shared/optim/GurobiSolver.h"
@@ -91,6 +93,36 @@ inline ILPSolver* getSolver(std::string wish, shared::optim::DirType dir) {
   return lp;
 }
 
+// progress callback which simply logs the solve progress
+inline void logProgress(const SolveProgress& p) {
+  LOGTO(INFO, std::cerr) << "(ILP) incumbent " << p.incumbent << ", bound "
+                         << p.bound << ", gap " << p.gap * 100 << "%, "
+                         << p.nodes << " nodes, " << p.time / 1000 << " s";
+}
+
+// names of the built-in solver parameter profiles
+inline std::vector<std::string> getProfileNames() {
+  return {"generic", "loom", "octi"};
+}
+
+inline SolverProfile getProfile(const std::string& name) {
+  if (name == "loom") return LOOM_ORDERING;
+  if (name == "octi") return OCTI_GRID;
+  if (name.size() && name != "generic") {
+    LOG(WARN) << "Unknown ILP solver profile '" << name
+              << "', using generic profile";
+  }
+  return GENERIC;
+}
+
+inline ILPSolver* getSolver(const std::string& wish,
+                            shared::optim::DirType dir,
+                            const std::string& profile) {
+  ILPSolver* lp = getSolver(wish, dir);
+  lp->setProfile(getProfile(profile));
+  return lp;
+}
+
 }  // namespace optim
 }  // namespace shared
 
@@ -5,8 +5,13 @@
 #ifndef SHARED_OPTIM_ILPSOLVER_H_
 #define SHARED_OPTIM_ILPSOLVER_H_
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <functional>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <string>
 
 namespace shared {
@@ -17,8 +22,27 @@ enum RowType { FIX, UP, LO };
 enum DirType { MAX, MIN };
 enum SolveType { OPTIM, INF, NON_OPTIM };
 
+// solver parameter profiles, tuned for the model types built by loom and octi
+enum SolverProfile { GENERIC, LOOM_ORDERING, OCTI_GRID };
+
 typedef std::map<std::string, int> StarterSol;
 
+// snapshot of a running branch & bound solve
+struct SolveProgress {
+  // objective value of the best known solution, infinity if none yet
+  double incumbent;
+  // best known objective bound
+  double bound;
+  // relative gap between incumbent and bound
+  double gap;
+  // number of branch & bound nodes explored so far
+  size_t nodes;
+  // elapsed solve time in ms
+  double time;
+};
+
+typedef std::function<void(const SolveProgress&)> ProgressCb;
+
 class ILPSolver {
  public:
   ILPSolver(){};
@@ -55,6 +79,34 @@ class ILPSolver {
   virtual void setNumThreads(int n) = 0;
   virtual int getNumThreads() const = 0;
 
+  virtual void setProfile(SolverProfile p) = 0;
+  virtual SolverProfile getProfile() const = 0;
+
+  // stop as soon as the relative gap falls below gap, 0 means solver default
+  virtual void setRelGapLim(double gap) = 0;
+  virtual double getRelGapLim() const = 0;
+
+  // cb is called on every new incumbent, and otherwise about once a second
+  void setProgressCb(const ProgressCb& cb) { _progressCb = cb; }
+
+  // may be called concurrently from the solver threads (CBC clones its event
+  // handler per thread), the callback itself is never called concurrently
+  void reportProgress(const SolveProgress& p, bool force) {
+    if (!_progressCb) return;
+    std::lock_guard<std::mutex> lock(_progressMtx);
+    if (!force && p.time - _lastProgress < 1000) return;
+    _lastProgress = p.time;
+    _progressCb(p);
+  }
+
+  static double relGap(double incumbent, double bound) {
+    if (std::abs(incumbent) >= 1e100) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return std::abs(incumbent - bound) /
+           std::max(std::abs(incumbent), 1e-10);
+  }
+
   virtual SolveType solve() = 0;
   virtual SolveType getStatus() = 0;
   virtual void update() = 0;
@@ -73,6 +125,11 @@ class ILPSolver {
 
     for (auto kv : sol) fo << kv.first << "\t" << kv.second << "\n";
   }
+
+ private:
+  ProgressCb _progressCb;
+  double _lastProgress = -std::numeric_limits<double>::infinity();
+  std::mutex _progressMtx;
 };
 
 }  // namespace optim